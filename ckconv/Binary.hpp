@@ -0,0 +1,279 @@
+/**
+ * @file	Binary.hpp
+ * @author	radj307
+ * @brief	Contains the raw binary mode (--binary), which scales arrays of little-endian float32 or float64 values without formatting them as text.
+ */
+#pragma once
+#include "conv.hpp"
+#include "numeric.hpp"
+#include "WordReader.hpp"
+#include "MappedFile.hpp"
+#include "Stats.hpp"
+
+#include <sysarch.h>
+#include <make_exception.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#include <cstdio>
+#endif
+
+namespace ckconv::binary {
+	/// @brief	The number of values that are converted at a time when streaming.
+	inline constexpr const size_t BLOCK_SIZE{ 1ull << 16ull };
+
+	/// @brief	Get the size of a value in bytes, or 0 if the number type can't be used in binary mode.
+	inline constexpr size_t element_size(const NumberType& type) noexcept
+	{
+		switch (type) {
+		case NumberType::FLOAT:
+			return sizeof(float);
+		case NumberType::DOUBLE:
+			return sizeof(double);
+		default:
+			return 0ull;
+		}
+	}
+
+	/// @brief	Reverse the byte order of a value.
+	template<typename T>
+	inline T byteswap(const T& value) noexcept
+	{
+		using U = std::conditional_t<sizeof(T) == 4ull, std::uint32_t, std::uint64_t>;
+		auto bits{ std::bit_cast<U>(value) }, swapped{ U{ 0 } };
+		for (size_t i{ 0ull }; i < sizeof(U); ++i, bits >>= 8u)
+			swapped = (swapped << 8u) | (bits & 0xFFu);
+		return std::bit_cast<T>(swapped);
+	}
+
+	/**
+	 * @brief			Multiply an array of little-endian values by a factor, using the fastest instruction set available.
+	 *\n				in & out may be the same array.
+	 * @param in		Input values.
+	 * @param out		Output values, which must be at least n elements long.
+	 * @param n			The number of values.
+	 * @param factor	The conversion factor.
+	 */
+	template<typename T> requires (std::same_as<T, float> || std::same_as<T, double>)
+	inline void scale(const T* in, T* out, const size_t& n, const T& factor) noexcept
+	{
+		stats::Timer timer{ stats::Stage::CONVERT, true };
+		if constexpr (std::endian::native == std::endian::little)
+			simd::scale(in, out, n, factor);
+		else for (size_t i{ 0ull }; i < n; ++i)
+			out[i] = byteswap(byteswap(in[i]) * factor);
+	}
+
+	/// @brief	Get a pointer to the values in a mapped file. Mappings are page-aligned, so they are always suitably aligned for T.
+	template<typename T, typename C>
+	inline auto values(C* data) noexcept
+	{
+		if constexpr (std::is_const_v<C>)
+			return reinterpret_cast<const T*>(data);
+		else
+			return reinterpret_cast<T*>(data);
+	}
+
+	/// @brief	Throw if a buffer doesn't contain a whole number of values.
+	template<typename T>
+	inline void check_size(const size_t& size, const std::string_view& name)
+	{
+		if (size % sizeof(T) != 0ull)
+			throw make_exception("The size of ", name, " (", size, " bytes) isn't a multiple of ", sizeof(T), " bytes!");
+	}
+
+	/// @brief	Write converted values to an output stream, and throw if it fails; a full disk or closed pipe must not be reported as success.
+	template<typename T>
+	inline void write_values(std::ostream& os, const T* data, const size_t& bytes)
+	{
+		if (!os.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(bytes)))
+			throw make_exception("Failed to write output!");
+	}
+
+	/// @brief	Flush an output stream, and throw if any buffered values couldn't be written.
+	inline void flush_values(std::ostream& os)
+	{
+		if (!os.flush())
+			throw make_exception("Failed to write output!");
+	}
+
+	/**
+	 * @brief			Read values from a file descriptor until EOF, and write the converted values to an output stream.
+	 * @param fd		Input file descriptor.
+	 * @param os		Output stream, which must be in binary mode.
+	 * @param factor	The conversion factor.
+	 */
+	template<typename T>
+	inline void convert_stream(const int& fd, std::ostream& os, const T& factor)
+	{
+		WordReader reader{ fd, BLOCK_SIZE * sizeof(T) };
+		std::vector<T> scratch(BLOCK_SIZE);
+		// a value that was split across two reads
+		char partial[sizeof(T)]{};
+		size_t partial_size{ 0ull };
+		while (const auto block{ reader.next_block() }) {
+			auto bytes{ block.value() };
+			if (partial_size > 0ull) {
+				const auto count{ std::min(sizeof(T) - partial_size, bytes.size()) };
+				std::memcpy(partial + partial_size, bytes.data(), count);
+				partial_size += count;
+				bytes.remove_prefix(count);
+				if (partial_size < sizeof(T))
+					continue;
+				T value;
+				std::memcpy(&value, partial, sizeof(T));
+				scale(&value, &value, 1ull, factor);
+				write_values(os, &value, sizeof(T));
+				partial_size = 0ull;
+			}
+			const auto size{ bytes.size() - bytes.size() % sizeof(T) };
+			for (size_t i{ 0ull }; i < size; i += scratch.size() * sizeof(T)) {
+				const auto count{ std::min(scratch.size() * sizeof(T), size - i) };
+				std::memcpy(scratch.data(), bytes.data() + i, count);
+				scale(scratch.data(), scratch.data(), count / sizeof(T), factor);
+				write_values(os, scratch.data(), count);
+			}
+			partial_size = bytes.size() - size;
+			std::memcpy(partial, bytes.data() + size, partial_size);
+		}
+		if (partial_size > 0ull)
+			throw make_exception("STDIN ended in the middle of a ", sizeof(T), "-byte value!");
+		flush_values(os);
+	}
+
+	/**
+	 * @brief			Convert a file in place.
+	 * @param path		The file to convert.
+	 * @param factor	The conversion factor.
+	 */
+	template<typename T>
+	inline void convert_in_place(const std::filesystem::path& path, const T& factor)
+	{
+		MappedFile file{ path, MappedFile::Mode::READ_WRITE, 0ull, true };
+		check_size<T>(file.size(), path.generic_string());
+		scale(values<T>(file.data()), values<T>(file.data()), file.size() / sizeof(T), factor);
+		stats::count(stats::Counter::BYTES_OUT, file.size());
+	}
+
+	/**
+	 * @brief			Convert files into a single output file, in order.
+	 * @param paths		The files to convert.
+	 * @param output	The output file, which is created or overwritten.
+	 * @param factor	The conversion factor.
+	 */
+	template<typename T>
+	inline void convert_files(const std::vector<std::string>& paths, const std::filesystem::path& output, const T& factor)
+	{
+		std::vector<std::unique_ptr<MappedFile>> inputs;
+		size_t total{ 0ull };
+		for (const auto& path : paths) {
+			auto& file{ inputs.emplace_back(std::make_unique<MappedFile>(path, MappedFile::Mode::READ, 0ull, true)) };
+			check_size<T>(file->size(), path);
+			total += file->size();
+		}
+		MappedFile out{ output, MappedFile::Mode::CREATE, total, true };
+		// each input is a whole number of values, so every offset is aligned
+		size_t offset{ 0ull };
+		for (const auto& file : inputs) {
+			scale(values<T>(std::as_const(*file).data()), values<T>(out.data() + offset), file->size() / sizeof(T), factor);
+			offset += file->size();
+		}
+		stats::count(stats::Counter::BYTES_OUT, total);
+	}
+
+	/**
+	 * @brief			Convert files to an output stream, in order.
+	 * @param paths		The files to convert.
+	 * @param os		Output stream, which must be in binary mode.
+	 * @param factor	The conversion factor.
+	 */
+	template<typename T>
+	inline void convert_files(const std::vector<std::string>& paths, std::ostream& os, const T& factor)
+	{
+		std::vector<T> scratch(BLOCK_SIZE);
+		for (const auto& path : paths) {
+			const MappedFile file{ path, MappedFile::Mode::READ, 0ull, true };
+			check_size<T>(file.size(), path);
+			for (size_t i{ 0ull }; i < file.size(); i += scratch.size() * sizeof(T)) {
+				const auto count{ std::min(scratch.size() * sizeof(T), file.size() - i) };
+				scale(values<T>(file.data() + i), scratch.data(), count / sizeof(T), factor);
+				write_values(os, scratch.data(), count);
+			}
+		}
+		flush_values(os);
+	}
+
+	/**
+	 * @brief				Run binary mode.
+	 * @param type			The type of each value; NumberType::FLOAT or NumberType::DOUBLE.
+	 * @param in			The unit that the input values are in.
+	 * @param out			The unit to convert them to.
+	 * @param use_stdin		When true, STDIN is converted before any input files.
+	 * @param inputs		Input files.
+	 * @param output		Output file. When empty, output is written to STDOUT.
+	 * @param in_place		When true, each input file is overwritten with its converted values, and nothing is written to STDOUT.
+	 */
+	inline void convert(const NumberType& type, const UnitId& in, const UnitId& out, const bool& use_stdin, const std::vector<std::string>& inputs, const std::filesystem::path& output, const bool& in_place)
+	{
+		if (element_size(type) == 0ull)
+			throw make_exception("Binary mode only supports f32 & f64 values!");
+		if (in_place && (use_stdin || !output.empty()))
+			throw make_exception("In-place conversion can't be combined with STDIN or an output file!");
+		else if (in_place && inputs.empty())
+			throw make_exception("In-place conversion requires at least one input file!");
+		// the output file is truncated before the inputs are read, so it must not be one of them, either by path or through a link
+		if (!output.empty()) {
+			for (const auto& path : inputs) {
+				std::error_code ec;
+				if (std::filesystem::equivalent(path, output, ec))
+					throw make_exception("Output file ", output, " is the same file as input ", std::filesystem::path{ path }, "; use --in-place to overwrite input files!");
+			}
+		}
+
+		visit_number_type(type, [&]<typename T>() {
+			if constexpr (std::same_as<T, float> || std::same_as<T, double>) {
+				const auto factor{ conversion_factor<T>(in, out) };
+				if (in_place) {
+					for (const auto& path : inputs)
+						convert_in_place(path, factor);
+					return;
+				}
+
+				#ifdef OS_WIN
+				_setmode(_fileno(stdin), _O_BINARY);
+				_setmode(_fileno(stdout), _O_BINARY);
+				#endif
+				if (output.empty()) {
+					if (use_stdin)
+						convert_stream(0, std::cout, factor);
+					convert_files(inputs, std::cout, factor);
+				}
+				else if (use_stdin) {
+					std::ofstream ofs{ output, std::ios_base::binary | std::ios_base::trunc };
+					if (!ofs)
+						throw make_exception("Failed to open output file ", output);
+					// the size of STDIN isn't known in advance, so the output file is written as a stream instead of being mapped
+					stats::CountingBuffer buffer{ ofs.rdbuf() };
+					std::ostream os{ &buffer };
+					convert_stream(0, os, factor);
+					convert_files(inputs, os, factor);
+				}
+				else convert_files(inputs, output, factor);
+			}
+		});
+	}
+}
@@ -0,0 +1,167 @@
+/**
+ * @file	ConfigCache.hpp
+ * @author	radj307
+ * @brief	Contains the config cache, which stores a validated snapshot of the configuration file so that the INI is only parsed after it changes.
+ */
+#pragma once
+#include "Global.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace ckconv::config {
+	/// @brief	Identifies a cache file, and the layout of its contents. Increment the last character whenever the layout changes.
+	inline constexpr const std::string_view CACHE_MAGIC{ "CKCC1" };
+
+	/**
+	 * @struct	Stamp
+	 * @brief	The modification time & size of the configuration file; the cache is only used while both are unchanged.
+	 */
+	struct Stamp {
+		std::int64_t mtime;
+		std::uint64_t size;
+	};
+
+	/// @brief	Get the path of the cache of the given configuration file, which is stored alongside it.
+	inline std::filesystem::path cache_path(const std::filesystem::path& ini_path)
+	{
+		auto path{ ini_path };
+		path += ".cache";
+		return path;
+	}
+
+	namespace detail {
+		template<typename T>
+		inline void put(std::string& out, const T& value)
+		{
+			out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+		template<typename T>
+		inline bool get(std::string_view& in, T& value) noexcept
+		{
+			if (in.size() < sizeof(T))
+				return false;
+			std::memcpy(&value, in.data(), sizeof(T));
+			in.remove_prefix(sizeof(T));
+			return true;
+		}
+
+		enum Flags : std::uint8_t {
+			HAS_PRECISION = 1u << 0u,
+			HAS_NOTATION = 1u << 1u,
+			HAS_NUMBER_TYPE = 1u << 2u,
+			QUIET = 1u << 3u,
+			NO_COLOR = 1u << 4u,
+		};
+	}
+
+	/**
+	 * @brief			Serialize a snapshot, along with the stamp of the configuration file it was read from & the current version.
+	 * @param stamp		The stamp of the configuration file.
+	 * @param config	The snapshot to serialize.
+	 * @returns			std::string
+	 */
+	inline std::string serialize(const Stamp& stamp, const ConfigSnapshot& config)
+	{
+		constexpr std::string_view version{ ckconv_VERSION };
+		std::string out{ CACHE_MAGIC };
+		detail::put(out, static_cast<std::uint8_t>(version.size()));
+		out += version;
+		detail::put(out, stamp.mtime);
+		detail::put(out, stamp.size);
+		std::uint8_t flags{ 0u };
+		if (config.precision.has_value())
+			flags |= detail::HAS_PRECISION;
+		if (config.notation.has_value())
+			flags |= detail::HAS_NOTATION;
+		if (config.number_type.has_value())
+			flags |= detail::HAS_NUMBER_TYPE;
+		if (config.quiet)
+			flags |= detail::QUIET;
+		if (config.no_color)
+			flags |= detail::NO_COLOR;
+		detail::put(out, flags);
+		detail::put(out, static_cast<std::int64_t>(config.precision.value_or(0)));
+		detail::put(out, static_cast<std::uint8_t>(config.notation.value_or(Notation::AUTO)));
+		detail::put(out, static_cast<std::uint8_t>(config.number_type.value_or(NumberType::LONG_DOUBLE)));
+		return out;
+	}
+
+	/**
+	 * @brief			Deserialize a snapshot, if it was written by this version of ckconv & the configuration file hasn't changed since.
+	 * @param in		The contents of a cache file.
+	 * @param stamp		The current stamp of the configuration file.
+	 * @returns			std::optional<ConfigSnapshot>; std::nullopt when the cache is stale or invalid.
+	 */
+	inline std::optional<ConfigSnapshot> deserialize(std::string_view in, const Stamp& stamp) noexcept
+	{
+		constexpr std::string_view version{ ckconv_VERSION };
+		if (!in.starts_with(CACHE_MAGIC))
+			return std::nullopt;
+		in.remove_prefix(CACHE_MAGIC.size());
+
+		std::uint8_t version_size;
+		if (!detail::get(in, version_size) || in.substr(0ull, version_size) != version)
+			return std::nullopt;
+		in.remove_prefix(version_size);
+
+		Stamp cached;
+		if (!detail::get(in, cached.mtime) || !detail::get(in, cached.size) || cached.mtime != stamp.mtime || cached.size != stamp.size)
+			return std::nullopt;
+
+		std::uint8_t flags, notation, number_type;
+		std::int64_t precision;
+		if (!detail::get(in, flags) || !detail::get(in, precision) || !detail::get(in, notation) || !detail::get(in, number_type) || !in.empty())
+			return std::nullopt;
+
+		ConfigSnapshot config;
+		if (flags & detail::HAS_PRECISION)
+			config.precision = static_cast<std::streamsize>(precision);
+		if (flags & detail::HAS_NOTATION)
+			config.notation = static_cast<Notation>(notation);
+		if (flags & detail::HAS_NUMBER_TYPE)
+			config.number_type = static_cast<NumberType>(number_type);
+		config.quiet = (flags & detail::QUIET) != 0u;
+		config.no_color = (flags & detail::NO_COLOR) != 0u;
+		return config;
+	}
+
+	/**
+	 * @brief			Read the configuration file, using its cache when it is up to date. The cache is (re)written whenever the INI has to be parsed.
+	 *\n				Failing to read or write the cache isn't an error; the INI is parsed instead.
+	 * @param ini_path	The path of the configuration file.
+	 * @returns			std::optional<ConfigSnapshot>; std::nullopt when the configuration file doesn't exist.
+	 */
+	inline std::optional<ConfigSnapshot> load(const std::filesystem::path& ini_path)
+	{
+		std::error_code ec;
+		const auto mtime{ std::filesystem::last_write_time(ini_path, ec) };
+		if (ec)
+			return std::nullopt;
+		const auto size{ std::filesystem::file_size(ini_path, ec) };
+		if (ec)
+			return std::nullopt;
+		const Stamp stamp{ static_cast<std::int64_t>(mtime.time_since_epoch().count()), static_cast<std::uint64_t>(size) };
+
+		const auto cache{ cache_path(ini_path) };
+		if (std::ifstream ifs{ cache, std::ios_base::binary }) {
+			char buffer[256];
+			ifs.read(buffer, sizeof(buffer));
+			if (const auto config{ deserialize({ buffer, static_cast<size_t>(ifs.gcount()) }, stamp) }; config.has_value())
+				return config;
+		}
+
+		const auto config{ read_config(file::INI(ini_path)) };
+		if (std::ofstream ofs{ cache, std::ios_base::binary | std::ios_base::trunc }) {
+			const auto data{ serialize(stamp, config) };
+			ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+		}
+		return config;
+	}
+}
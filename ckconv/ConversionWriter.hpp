@@ -0,0 +1,99 @@
+/**
+ * @file	ConversionWriter.hpp
+ * @author	radj307
+ * @brief	Contains the ConversionWriter class, which formats conversions on a thread pool & writes them in input order.
+ */
+#pragma once
+#include "Convert.hpp"
+#include "ThreadPool.hpp"
+
+#include <deque>
+#include <memory>
+#include <sstream>
+
+namespace ckconv {
+	/**
+	 * @class	ConversionWriter
+	 * @brief	Writes conversions to an output stream, one per line, in the order that they were pushed.
+	 *\n		With a single job, each conversion is written immediately. Otherwise conversions are grouped into chunks
+	 *\n		 that are converted & formatted on a thread pool, and the formatted chunks are written in order.
+	 *\n		At most 2 chunks per job are in flight at once, so memory usage is bounded.
+	 * @tparam ConvertT	The conversion type, such as Convert or BasicConvert<float>.
+	 */
+	template<typename ConvertT = Convert>
+	class ConversionWriter {
+		std::ostream& _os;
+		std::unique_ptr<ThreadPool> _pool;
+		size_t _chunk_size, _max_pending;
+		std::vector<ConvertT> _chunk;
+		std::deque<std::future<std::string>> _pending;
+
+		/// @brief	Convert & format a chunk.
+		static std::string format(const std::vector<ConvertT>& chunk)
+		{
+			std::ostringstream ss;
+			for (const auto& conv : chunk)
+				ss << conv << '\n';
+			return std::move(ss).str();
+		}
+
+		/// @brief	Write the oldest pending chunk, waiting for it to be finished if necessary.
+		void write_next()
+		{
+			const auto str{ _pending.front().get() };
+			_pending.pop_front();
+			_os.write(str.data(), static_cast<std::streamsize>(str.size()));
+		}
+
+		/// @brief	Submit the current chunk to the thread pool.
+		void submit()
+		{
+			if (_chunk.empty())
+				return;
+			_pending.emplace_back(_pool->submit([chunk = std::move(_chunk)]() { return format(chunk); }));
+			_chunk = {};
+			_chunk.reserve(_chunk_size);
+			while (_pending.size() > _max_pending)
+				write_next();
+		}
+
+	public:
+		/// @brief	The default number of conversions in each chunk.
+		static constexpr const size_t DEFAULT_CHUNK_SIZE{ 4096ull };
+
+		/**
+		 * @brief				Constructor
+		 * @param os			Output stream to write to.
+		 * @param jobs			The number of threads to use for formatting. 0 & 1 both format on the calling thread.
+		 * @param chunk_size	The number of conversions in each chunk.
+		 */
+		ConversionWriter(std::ostream& os, const size_t& jobs = 1ull, const size_t& chunk_size = DEFAULT_CHUNK_SIZE) : _os{ os }, _pool{ jobs > 1ull ? std::make_unique<ThreadPool>(jobs) : nullptr }, _chunk_size{ std::max<size_t>(chunk_size, 1ull) }, _max_pending{ jobs * 2ull }
+		{
+			if (_pool)
+				_chunk.reserve(_chunk_size);
+		}
+
+		/// @brief	Queue a conversion for output.
+		void push(ConvertT&& conv)
+		{
+			if (!_pool) {
+				_os << conv << '\n';
+				return;
+			}
+			_chunk.emplace_back(std::move(conv));
+			if (_chunk.size() >= _chunk_size)
+				submit();
+		}
+
+		/// @brief	Write all queued conversions, blocking until they are finished.
+		void flush()
+		{
+			if (_pool) {
+				submit();
+				while (!_pending.empty())
+					write_next();
+			}
+			_os.flush();
+		}
+	};
+}
@@ -0,0 +1,368 @@
+/**
+ * @file	Convert.hpp
+ * @author	radj307
+ * @brief	Contains the BasicConvert & BasicVectorConvert structs, which parse, convert & format a single conversion.
+ */
+#pragma once
+#include "conv.hpp"
+#include "numeric.hpp"
+#include "Global.h"
+#include "Stats.hpp"
+
+#include <math.hpp>
+
+namespace ckconv {
+	/**
+	 * @struct	ParseError
+	 * @brief	Describes why a group of 3 words isn't a valid conversion.
+	 */
+	struct ParseError {
+		ckconv::Error error;
+		/// @brief	The index of the invalid word within the group, from 0 to 2.
+		unsigned char word;
+	};
+
+	namespace detail {
+		/// @brief	Retrieve the unit specified by a string without throwing, counting failed lookups.
+		inline expected<ckconv::UnitId, ckconv::Error> lookup(const std::string_view& str) noexcept
+		{
+			stats::Timer timer{ stats::Stage::LOOKUP };
+			const auto id{ ckconv::find_unit(str) };
+			if (!id.has_value())
+				stats::count(stats::Counter::FAILED_LOOKUPS);
+			return id;
+		}
+
+		/// @brief	Get the error that describes why parse_number() failed.
+		inline constexpr ckconv::Error number_error(const std::errc& ec) noexcept
+		{
+			return ec == std::errc::result_out_of_range ? ckconv::Error::NUMBER_OUT_OF_RANGE : ckconv::Error::INVALID_NUMBER;
+		}
+
+		/**
+		 * @brief			Parse a group of 3 words into units & a value, accepting the value as either the first or second word.
+		 * @tparam ValueT	The type of value.
+		 * @param parse		Function that parses a value, returning an error when the word isn't a value.
+		 * @returns			expected<std::tuple<UnitId, ValueT, UnitId>, ParseError>
+		 */
+		template<typename ValueT, typename Parser>
+		inline expected<std::tuple<ckconv::UnitId, ValueT, ckconv::UnitId>, ParseError> parse_group(const std::string_view& first, const std::string_view& second, const std::string_view& third, Parser&& parse) noexcept
+		{
+			ValueT value;
+			unsigned char unit_in_word{ 0u };
+			// the first argument is the value
+			if (!parse(first, value).has_value()) {
+				if (const auto result{ parse(second, value) }; !result.has_value())
+					return unexpected{ ParseError{ result.error(), 1u } };
+			}
+			else unit_in_word = 1u;
+
+			const auto unit_in{ lookup(unit_in_word == 0u ? first : second) };
+			if (!unit_in.has_value())
+				return unexpected{ ParseError{ unit_in.error(), unit_in_word } };
+			const auto unit_out{ lookup(third) };
+			if (!unit_out.has_value())
+				return unexpected{ ParseError{ unit_out.error(), 2u } };
+			return std::tuple<ckconv::UnitId, ValueT, ckconv::UnitId>{ unit_in.value(), value, unit_out.value() };
+		}
+
+		/// @brief	Throw the exception that describes an error in the given word.
+		[[noreturn]] inline void throw_parse_error(const ckconv::Error& error, const std::string_view& word)
+		{
+			switch (error) {
+			case ckconv::Error::EMPTY_UNIT:
+				throw make_exception("No unit specified ; string was empty!");
+			case ckconv::Error::INVALID_VECTOR:
+				throw make_exception("Invalid Vector: \"", word, "\"; expected 3 comma-separated numbers, such as \"1,2.5,-3\"");
+			default:
+				throw make_exception(ckconv::error_message(error), ": \"", word, '\"');
+			}
+		}
+
+		/// @brief	Throw the exception that describes a ParseError.
+		[[noreturn]] inline void throw_parse_error(const ParseError& err, const std::string_view& first, const std::string_view& second, const std::string_view& third)
+		{
+			throw_parse_error(err.error, err.word == 0u ? first : (err.word == 1u ? second : third));
+		}
+
+		/**
+		 * @brief			Append a formatted conversion to a string, using the pre-rendered palette & the current output settings.
+		 * @param out		The string to append to.
+		 * @param input		The formatted input value.
+		 * @param unit_in	Input Unit.
+		 * @param result	The formatted output value.
+		 * @param unit_out	Output Unit.
+		 * @param min_indent	The column to align the equals sign to.
+		 * @param continued	When true, this is a later target of a fan-out conversion; the input is replaced by spaces, so it lines up under the first.
+		 */
+		inline void append_conversion(std::string& out, const std::string_view& input, const ckconv::UnitId& unit_in, const std::string_view& result, const ckconv::UnitId& unit_out, const std::streamsize& min_indent, const bool& continued = false)
+		{
+			const auto unit_str{ [](const ckconv::UnitId& id) {
+				const auto& unit{ ckconv::getUnit(id) };
+				return Global.use_full_unit_names ? unit.getName() : unit.getSymbol();
+			} };
+			if (!Global.quiet) {
+				const auto input_unit_str{ unit_str(unit_in) };
+				const auto used{ static_cast<std::streamsize>(input.size() + input_unit_str.size() + 1ull) };
+				if (continued)
+					out.append(static_cast<size_t>(std::max(min_indent, used)), ' ');
+				else {
+					// insert input
+					out += Global.colors.set(OUT::INPUT_VALUE);
+					out += input;
+					out += Global.colors.reset();
+					out += ' ';
+					out += Global.colors.set(OUT::INPUT_UNIT);
+					out += input_unit_str;
+					out += Global.colors.reset();
+					if (min_indent > used)
+						out.append(static_cast<size_t>(min_indent - used), ' ');
+				}
+				out += Global.colors.set(OUT::EQUALS);
+				out += '=';
+				out += Global.colors.reset();
+				out += ' ';
+			}
+
+			out += Global.colors.set(OUT::OUTPUT_VALUE);
+			out += result;
+			out += Global.colors.reset();
+
+			if (!Global.quiet) {
+				out += ' ';
+				out += Global.colors.set(OUT::OUTPUT_UNIT);
+				out += unit_str(unit_out);
+				out += Global.colors.reset();
+			}
+		}
+
+		/**
+		 * @brief			Insert a formatted conversion into an output stream with a single write. The parameters are the same as append_conversion's.
+		 * @param os		Output stream.
+		 */
+		inline std::ostream& write_conversion(std::ostream& os, const std::string_view& input, const ckconv::UnitId& unit_in, const std::string_view& result, const ckconv::UnitId& unit_out, const std::streamsize& min_indent, const bool& continued = false)
+		{
+			thread_local std::string line;
+			line.clear();
+			append_conversion(line, input, unit_in, result, unit_out, min_indent, continued);
+			return os.write(line.data(), static_cast<std::streamsize>(line.size()));
+		}
+	}
+
+	/**
+	 * @struct	BasicConvert
+	 * @brief		Performs a single conversion operation, and exposes std::ostream operator<<() to format and insert it into an output stream.
+	 * @tparam T	The floating-point type that the value is parsed, converted & formatted in.
+	 */
+	template<std::floating_point T>
+	struct BasicConvert {
+		using NumberT = T;
+		using ValueT = NumberT;
+		using Tuple = std::tuple<ckconv::UnitId, NumberT, ckconv::UnitId>;
+	private:
+		// units are stored as one-byte handles, so a queued conversion holds no strings
+		NumberT _value;
+		std::streamsize _min_indent{ 0ull };
+		ckconv::UnitId _unit_in, _unit_out;
+		bool _continued{ false };
+
+		///	@brief	Returns the result of the conversion.
+		static inline NumberT getResult(const ckconv::UnitId& input_unit, const NumberT& input, const ckconv::UnitId& output_unit) noexcept(false)
+		{
+			stats::Timer timer{ stats::Stage::CONVERT };
+			if (math::equal(input, static_cast<NumberT>(0))) // if input is 0, short-circuit and return 0
+				return static_cast<NumberT>(0);
+			return ckconv::convert(input_unit, input, output_unit);
+		}
+
+		BasicConvert(const Tuple& vars, const std::streamsize& min_indent) : BasicConvert(std::get<0>(vars), std::get<1>(vars), std::get<2>(vars), min_indent) {}
+
+		static inline BasicConvert make(const std::string_view& first, const std::string_view& second, const std::string_view& third, const std::streamsize& min_indent)
+		{
+			auto conv{ try_make(first, second, third, min_indent) };
+			if (!conv.has_value())
+				detail::throw_parse_error(conv.error(), first, second, third);
+			return std::move(*conv);
+		}
+
+	public:
+		/**
+		 * @brief			Constructor
+		 * @param unit_in	Input Unit (OR Input Value, if val_in is the input unit)
+		 * @param val_in	Input Value (OR Input Unit, if unit_in is the input value)
+		 * @param unit_out	Output Unit
+		 * @throws ex::except	When the words aren't a valid conversion.
+		 */
+		BasicConvert(const std::string_view& unit_in, const std::string_view& val_in, const std::string_view& unit_out, const std::streamsize& min_indent = 0ull) : BasicConvert(make(unit_in, val_in, unit_out, min_indent)) {}
+
+		/**
+		 * @brief			Constructor that takes a value & units that have already been parsed.
+		 * @param unit_in	Input Unit
+		 * @param value		Input Value
+		 * @param unit_out	Output Unit
+		 * @param continued	When true, this is a later target of a fan-out conversion, and is formatted without its input. See detail::append_conversion().
+		 */
+		BasicConvert(const ckconv::UnitId& unit_in, const NumberT& value, const ckconv::UnitId& unit_out, const std::streamsize& min_indent = 0ull, const bool& continued = false) noexcept : _value{ value }, _min_indent{ min_indent }, _unit_in{ unit_in }, _unit_out{ unit_out }, _continued{ continued } {}
+
+		/// @brief	Parse a number, timing it as part of the parse stage.
+		static inline expected<bool, ckconv::Error> parse_value(const std::string_view& str, NumberT& value) noexcept
+		{
+			stats::Timer timer{ stats::Stage::PARSE };
+			if (const auto ec{ ckconv::parse_number(str, value) }; ec != std::errc{})
+				return unexpected{ detail::number_error(ec) };
+			return true;
+		}
+
+		/**
+		 * @brief			Parse a conversion without throwing. The parameters are the same as the constructor's.
+		 * @returns			expected<BasicConvert, ParseError>
+		 */
+		static inline expected<BasicConvert, ParseError> try_make(const std::string_view& unit_in, const std::string_view& val_in, const std::string_view& unit_out, const std::streamsize& min_indent = 0ull) noexcept
+		{
+			const auto vars{ detail::parse_group<NumberT>(unit_in, val_in, unit_out, parse_value) };
+			if (!vars.has_value())
+				return unexpected{ vars.error() };
+			return BasicConvert{ vars.value(), min_indent };
+		}
+
+		NumberT operator()() const { return getResult(_unit_in, _value, _unit_out); }
+
+		/**
+		 * @brief	Format and print the result of the conversion to the given ostream instance.
+		 * @returns	std::ostream&
+		 */
+		friend std::ostream& operator<<(std::ostream& os, const BasicConvert& conv)
+		{
+			stats::Timer timer{ stats::Stage::FORMAT };
+			const auto precision{ static_cast<int>(Global.precision) };
+
+			// numbers are formatted into a reused buffer, so nothing is allocated once it is large enough
+			thread_local std::string buffer;
+			buffer.clear();
+			if (!Global.quiet)
+				ckconv::append_number(buffer, conv._value, precision, Global.notation);
+			const auto input_length{ buffer.size() };
+			ckconv::append_number(buffer, conv.getResult(conv._unit_in, conv._value, conv._unit_out), precision, Global.notation);
+
+			const std::string_view formatted{ buffer };
+			return detail::write_conversion(os, formatted.substr(0ull, input_length), conv._unit_in, formatted.substr(input_length), conv._unit_out, conv._min_indent, conv._continued);
+		}
+	};
+
+	/// @brief	Conversions performed in long double, the default & most precise number type.
+	using Convert = BasicConvert<long double>;
+
+	/**
+	 * @struct		BasicVectorConvert
+	 * @brief		Performs a single conversion of an x,y,z vector, used by --vector. The interface is the same as BasicConvert.
+	 *\n			Vectors are written as 3 comma-separated numbers without spaces, optionally enclosed in parentheses: "1,2.5,-3" or "(1,2.5,-3)".
+	 * @tparam T	The floating-point type that each component is parsed, converted & formatted in.
+	 */
+	template<std::floating_point T>
+	struct BasicVectorConvert {
+		using NumberT = T;
+		using VectorT = ckconv::Vector3<T>;
+		using ValueT = VectorT;
+	private:
+		VectorT _value;
+		std::streamsize _min_indent{ 0ull };
+		ckconv::UnitId _unit_in, _unit_out;
+		bool _continued{ false };
+
+		static inline BasicVectorConvert make(const std::string_view& first, const std::string_view& second, const std::string_view& third, const std::streamsize& min_indent)
+		{
+			auto conv{ try_make(first, second, third, min_indent) };
+			if (!conv.has_value())
+				detail::throw_parse_error(conv.error(), first, second, third);
+			return std::move(*conv);
+		}
+
+	public:
+		/**
+		 * @brief			Constructor
+		 * @param unit_in	Input Unit (OR Input Vector, if val_in is the input unit)
+		 * @param val_in	Input Vector (OR Input Unit, if unit_in is the input vector)
+		 * @param unit_out	Output Unit
+		 */
+		BasicVectorConvert(const std::string_view& unit_in, const std::string_view& val_in, const std::string_view& unit_out, const std::streamsize& min_indent = 0ull) : BasicVectorConvert(make(unit_in, val_in, unit_out, min_indent)) {}
+
+		/**
+		 * @brief			Constructor that takes a vector & units that have already been parsed.
+		 * @param unit_in	Input Unit
+		 * @param value		Input Vector
+		 * @param unit_out	Output Unit
+		 * @param continued	When true, this is a later target of a fan-out conversion, and is formatted without its input. See detail::append_conversion().
+		 */
+		BasicVectorConvert(const ckconv::UnitId& unit_in, const VectorT& value, const ckconv::UnitId& unit_out, const std::streamsize& min_indent = 0ull, const bool& continued = false) noexcept : _value{ value }, _min_indent{ min_indent }, _unit_in{ unit_in }, _unit_out{ unit_out }, _continued{ continued } {}
+
+		/// @brief	Parse a vector, timing it as part of the parse stage. Commas separate components, so thousands separators aren't allowed.
+		static inline expected<bool, ckconv::Error> parse_value(std::string_view str, VectorT& value) noexcept
+		{
+			stats::Timer timer{ stats::Stage::PARSE };
+			if (str.size() >= 2ull && str.front() == '(' && str.back() == ')')
+				str = str.substr(1ull, str.size() - 2ull);
+			T components[3];
+			for (size_t i{ 0ull }; i < 3ull; ++i) {
+				const auto end{ str.find(',') };
+				if ((end == std::string_view::npos) != (i == 2ull)) // not exactly 3 components
+					return unexpected{ ckconv::Error::INVALID_VECTOR };
+				if (const auto ec{ ckconv::parse_number(str.substr(0ull, end), components[i]) }; ec != std::errc{})
+					return unexpected{ ec == std::errc::result_out_of_range ? ckconv::Error::NUMBER_OUT_OF_RANGE : ckconv::Error::INVALID_VECTOR };
+				if (end != std::string_view::npos)
+					str.remove_prefix(end + 1ull);
+			}
+			value = { components[0], components[1], components[2] };
+			return true;
+		}
+
+		/**
+		 * @brief			Parse a conversion without throwing. The parameters are the same as the constructor's.
+		 * @returns			expected<BasicVectorConvert, ParseError>
+		 */
+		static inline expected<BasicVectorConvert, ParseError> try_make(const std::string_view& unit_in, const std::string_view& val_in, const std::string_view& unit_out, const std::streamsize& min_indent = 0ull) noexcept
+		{
+			const auto vars{ detail::parse_group<VectorT>(unit_in, val_in, unit_out, parse_value) };
+			if (!vars.has_value())
+				return unexpected{ vars.error() };
+			return BasicVectorConvert{ std::get<0>(vars.value()), std::get<1>(vars.value()), std::get<2>(vars.value()), min_indent };
+		}
+
+		VectorT operator()() const
+		{
+			stats::Timer timer{ stats::Stage::CONVERT };
+			return ckconv::convert(_unit_in, _value, _unit_out);
+		}
+
+		/// @brief	Format a vector & append it to the given string.
+		static inline void append_vector(std::string& out, const VectorT& vec, const int& precision)
+		{
+			const T components[]{ vec.x, vec.y, vec.z };
+			for (size_t i{ 0ull }; i < 3ull; ++i) {
+				if (i > 0ull)
+					out += ',';
+				// zero is always formatted as 0, the same as BasicConvert's short-circuit
+				ckconv::append_number(out, math::equal(components[i], static_cast<T>(0)) ? static_cast<T>(0) : components[i], precision, Global.notation);
+			}
+		}
+
+		/**
+		 * @brief	Format and print the result of the conversion to the given ostream instance.
+		 * @returns	std::ostream&
+		 */
+		friend std::ostream& operator<<(std::ostream& os, const BasicVectorConvert& conv)
+		{
+			stats::Timer timer{ stats::Stage::FORMAT };
+			const auto precision{ static_cast<int>(Global.precision) };
+
+			thread_local std::string buffer;
+			buffer.clear();
+			if (!Global.quiet)
+				append_vector(buffer, conv._value, precision);
+			const auto input_length{ buffer.size() };
+			append_vector(buffer, conv(), precision);
+
+			const std::string_view formatted{ buffer };
+			return detail::write_conversion(os, formatted.substr(0ull, input_length), conv._unit_in, formatted.substr(input_length), conv._unit_out, conv._min_indent, conv._continued);
+		}
+	};
+}
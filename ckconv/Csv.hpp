@@ -0,0 +1,300 @@
+/**
+ * @file	Csv.hpp
+ * @author	radj307
+ * @brief	Contains the CsvConverter class, which converts selected columns of a delimited file in a single pass.
+ */
+#pragma once
+#include "conv.hpp"
+#include "numeric.hpp"
+#include "Global.h"
+#include "Stats.hpp"
+
+#include <make_exception.hpp>
+#include <math.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ckconv {
+	/// @brief	Remove leading & trailing spaces, tabs & carriage returns.
+	inline constexpr std::string_view trim_field(std::string_view field) noexcept
+	{
+		constexpr const std::string_view WHITESPACE{ " \t\r" };
+		const auto begin{ field.find_first_not_of(WHITESPACE) };
+		if (begin == std::string_view::npos)
+			return{};
+		return field.substr(begin, field.find_last_not_of(WHITESPACE) + 1ull - begin);
+	}
+
+	/**
+	 * @struct	CsvColumns
+	 * @brief	The columns selected by --csv or --tsv, by 1-based index and/or by header name.
+	 */
+	struct CsvColumns {
+		std::vector<size_t> indices;
+		std::vector<std::string> names;
+
+		/**
+		 * @brief		Parse a comma-separated list of columns, such as "2,3,4" or "X,Y,Z".
+		 * @param list	Columns are 1-based indices, or names from the header row.
+		 * @returns		CsvColumns
+		 */
+		static CsvColumns parse(const std::string_view& list)
+		{
+			CsvColumns columns;
+			for (size_t begin{ 0ull }; begin <= list.size();) {
+				auto end{ list.find(',', begin) };
+				if (end == std::string_view::npos)
+					end = list.size();
+				const auto column{ trim_field(list.substr(begin, end - begin)) };
+				if (column.empty())
+					throw make_exception("Invalid column list: \"", list, "\" contains an empty column!");
+				else if (std::all_of(column.begin(), column.end(), isdigit)) {
+					const auto index{ static_cast<size_t>(str::stoll(std::string{ column })) };
+					if (index == 0ull)
+						throw make_exception("Invalid column list: \"", list, "\" column indices start at 1!");
+					columns.indices.emplace_back(index - 1ull);
+				}
+				else columns.names.emplace_back(column);
+				begin = end + 1ull;
+			}
+			return columns;
+		}
+	};
+
+	/**
+	 * @class		CsvConverter
+	 * @brief		Streams a delimited file, converting the values in the selected columns from one unit to another.
+	 *\n			Every other field, the delimiters, quoting & line endings are passed through unchanged, and rows are written in order.
+	 *\n			Input can be fed in blocks of any size; only the current field of a converted column & one block of output are buffered.
+	 *\n			If the first row has a non-numeric value in a converted column, or any columns are selected by name, it is treated as a header & passed through.
+	 * @tparam T	The floating-point type that values are parsed, converted & formatted in.
+	 */
+	template<std::floating_point T = long double>
+	class CsvConverter {
+		enum class State : char {
+			FIELD_START,
+			UNQUOTED,
+			QUOTED,
+			/// @brief	A quote inside of a quoted field; either the end of the field, or the first half of an escaped quote.
+			QUOTE,
+		};
+
+		std::ostream& _os;
+		const char _delimiter;
+		const UnitId _in, _out;
+		CsvColumns _columns;
+		/// @brief	Whether each column is converted, indexed by 0-based column. Columns past the end are not converted.
+		std::vector<bool> _convert;
+		State _state{ State::FIELD_START };
+		size_t _row{ 0ull }, _column{ 0ull }, _converted{ 0ull };
+		/// @brief	The offset in _buffer where the current row begins.
+		size_t _row_begin{ 0ull };
+		/// @brief	The raw bytes & unquoted contents of the current field, only when it is being converted (or is part of the header).
+		std::string _raw, _value;
+		std::vector<std::string> _header;
+		std::string _buffer;
+
+		static constexpr const size_t BLOCK_SIZE{ 1ull << 16ull };
+
+		bool converting() const noexcept { return _row == 0ull ? !_columns.names.empty() || is_converted(_column) : is_converted(_column); }
+		bool is_converted(const size_t& column) const noexcept { return column < _convert.size() && _convert[column]; }
+
+		void select(const size_t& column)
+		{
+			if (column >= _convert.size())
+				_convert.resize(column + 1ull, false);
+			_convert[column] = true;
+		}
+
+		/// @brief	Resolve the columns that were selected by name, once the header row is complete.
+		void resolve_header()
+		{
+			for (const auto& name : _columns.names) {
+				const auto it{ std::find(_header.begin(), _header.end(), name) };
+				if (it == _header.end())
+					throw make_exception("CSV column \"", name, "\" doesn't exist in the header row!");
+				select(static_cast<size_t>(std::distance(_header.begin(), it)));
+			}
+			_header.clear();
+			_header.shrink_to_fit();
+		}
+
+		/// @brief	Append bytes to the current field; when it isn't converted, they are passed straight through.
+		void append(const std::string_view& bytes, const bool& is_value)
+		{
+			if (!converting())
+				_buffer += bytes;
+			else {
+				_raw += bytes;
+				if (is_value)
+					_value += bytes;
+			}
+		}
+
+		/// @brief	Convert & write the current field, or write it unchanged if it isn't a number.
+		void end_field()
+		{
+			if (converting()) {
+				if (_row == 0ull && !_columns.names.empty())
+					_header.emplace_back(trim_field(_value));
+
+				const auto number{ trim_field(_value) };
+				T value;
+				if (number.empty() || (_row == 0ull && !_columns.names.empty()))
+					_buffer += _raw; // empty fields & the header row are passed through
+				else if ([&]() { stats::Timer timer{ stats::Stage::PARSE }; return parse_number(number, value); }() == std::errc{}) {
+					T result;
+					{
+						stats::Timer timer{ stats::Stage::CONVERT };
+						result = math::equal(value, static_cast<T>(0)) ? static_cast<T>(0) : ckconv::convert(_in, value, _out);
+					}
+					// the number replaces only its own bytes in the raw field, so quotes & whitespace around it,
+					//  such as the carriage return of a CRLF line ending, are passed through unchanged
+					const auto pos{ _raw.find(number) };
+					_buffer.append(_raw, 0ull, pos);
+					{
+						stats::Timer timer{ stats::Stage::FORMAT };
+						append_number(_buffer, result, static_cast<int>(Global.precision), Global.notation);
+					}
+					_buffer.append(_raw, pos + number.size());
+					++_converted;
+				}
+				else if (_row == 0ull)
+					_buffer += _raw; // a header row
+				else if (Global.skip_invalid) {
+					_buffer += _raw;
+					std::cerr << "Skipped row " << _row + 1ull << ", column " << _column + 1ull << ":  " << error_message(Error::INVALID_NUMBER) << " \"" << number << "\"\n";
+					stats::count(stats::Counter::SKIPPED);
+				}
+				else {
+					// write every complete row before the invalid one
+					_os.write(_buffer.data(), static_cast<std::streamsize>(_row_begin));
+					_os.flush();
+					_buffer.clear();
+					_row_begin = 0ull;
+					throw make_exception("Invalid Number: \"", number, "\" (row ", _row + 1ull, ", column ", _column + 1ull, ')');
+				}
+				_raw.clear();
+				_value.clear();
+			}
+			++_column;
+			_state = State::FIELD_START;
+		}
+
+		/// @brief	End the current row, after the line feed has been appended. Output is written once a whole block of rows is buffered.
+		void end_row()
+		{
+			if (_row == 0ull && !_columns.names.empty())
+				resolve_header();
+			++_row;
+			_column = 0ull;
+			if (_buffer.size() >= BLOCK_SIZE) {
+				_os.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+				_buffer.clear();
+			}
+			_row_begin = _buffer.size();
+		}
+
+	public:
+		/**
+		 * @brief			Constructor.
+		 * @param os		Output stream to write the converted file to.
+		 * @param delimiter	The field delimiter; ',' for CSV or '\t' for TSV.
+		 * @param columns	The columns to convert.
+		 * @param in		The unit that values in the selected columns are in.
+		 * @param out		The unit to convert them to.
+		 */
+		CsvConverter(std::ostream& os, const char& delimiter, CsvColumns columns, const UnitId& in, const UnitId& out) : _os{ os }, _delimiter{ delimiter }, _in{ in }, _out{ out }, _columns{ std::move(columns) }
+		{
+			for (const auto& index : _columns.indices)
+				select(index);
+			_buffer.reserve(BLOCK_SIZE * 2ull);
+		}
+
+		/// @brief	Process the next block of input.
+		void feed(const std::string_view& block)
+		{
+			stats::Timer timer{ stats::Stage::TOKENIZE };
+			for (size_t i{ 0ull }; i < block.size();) {
+				const char ch{ block[i] };
+				switch (_state) {
+				case State::FIELD_START:
+					if (ch == '\"') {
+						_state = State::QUOTED;
+						append(block.substr(i++, 1ull), false);
+						break;
+					}
+					_state = State::UNQUOTED;
+					[[fallthrough]];
+				case State::UNQUOTED:
+					if (ch == _delimiter) {
+						end_field();
+						_buffer += block[i++];
+					}
+					else if (ch == '\n') {
+						end_field();
+						_buffer += block[i++];
+						end_row();
+					}
+					else { // append everything up to the next delimiter or line feed at once
+						auto end{ i + 1ull };
+						while (end < block.size() && block[end] != _delimiter && block[end] != '\n')
+							++end;
+						append(block.substr(i, end - i), true);
+						i = end;
+					}
+					break;
+				case State::QUOTED:
+					if (ch == '\"') {
+						_state = State::QUOTE;
+						append(block.substr(i++, 1ull), false);
+					}
+					else {
+						const auto end{ std::min(block.find('\"', i + 1ull), block.size()) };
+						append(block.substr(i, end - i), true);
+						i = end;
+					}
+					break;
+				case State::QUOTE:
+					if (ch == '\"') { // escaped quote
+						_state = State::QUOTED;
+						append(block.substr(i++, 1ull), true);
+					}
+					else if (ch == _delimiter) {
+						end_field();
+						_buffer += block[i++];
+					}
+					else if (ch == '\n') {
+						end_field();
+						_buffer += block[i++];
+						end_row();
+					}
+					else append(block.substr(i++, 1ull), true); // malformed; keep the text after the closing quote as part of the field
+					break;
+				}
+			}
+		}
+
+		/// @brief	Finish the last row, and write everything that is still buffered.
+		void finish()
+		{
+			if (_state != State::FIELD_START || _column > 0ull) {
+				end_field();
+				end_row();
+			}
+			_os.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+			_buffer.clear();
+			_os.flush();
+		}
+
+		/// @brief	The number of values that were converted.
+		size_t converted() const noexcept { return _converted; }
+		/// @brief	The number of rows that were read.
+		size_t rows() const noexcept { return _row; }
+	};
+}
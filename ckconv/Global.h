@@ -1,25 +1,27 @@
 #pragma once
 #include "version.h"
+#include "conv.hpp"
+#include "numeric.hpp"
+#include "OutputSink.hpp"
 
 #include <sysarch.h>
 #include <make_exception.hpp>
+#include <str.hpp>
+#include <var.hpp>
 #include <TermAPI.hpp>
 #include <palette.hpp>
 #include <ParamsAPI2.hpp>
 #include <INI.hpp>
 #include <fileutil.hpp>
 
+#include <array>
+#include <optional>
+#include <sstream>
+#include <string_view>
 #include <variant>
 #include <filesystem>
 #include <cmath>
-
-#ifdef OS_WIN
-/// @brief	This is used to keep track of the number output notation.
-using FmtFlag = std::_Iosb<int>::_Fmtflags;
-#else
-/// @brief	This is used to keep track of the number output notation.
-using FmtFlag = std::ios_base::fmtflags;
-#endif
+#include <thread>
 
 struct argument_except : public ex::except { argument_except(auto&& message) : ex::except(std::forward<decltype(message)>(message)) {} };
 template<typename... Ts>
@@ -40,8 +42,6 @@ inline argument_except argument_exception(const std::string& argument, const std
 	);
 }
 
-INLINE CONSTEXPR const FmtFlag* const FIXED{ &std::ios_base::fixed }, * SCIENTIFIC{ &std::ios_base::scientific };
-
 namespace ckconv {
 
 	/// @brief	Default executable name.
@@ -62,6 +62,44 @@ namespace ckconv {
 		EQUALS,
 		UNITS_SECTION_TEXT,
 	};
+	/// @brief	The number of values in the OUT enum.
+	inline constexpr const size_t OUT_COUNT{ static_cast<size_t>(OUT::UNITS_SECTION_TEXT) + 1ull };
+
+	/**
+	 * @struct	RenderedPalette
+	 * @brief	The escape sequences of a palette, rendered once so that writing one is a plain string copy.
+	 *\n		Every sequence is empty while the palette is disabled, so nothing is written at all.
+	 */
+	struct RenderedPalette {
+		std::array<std::string, OUT_COUNT> sequences;
+		std::string reset_sequence;
+
+		RenderedPalette(const term::palette<OUT>& palette) { render(palette); }
+
+		/// @brief	Render every sequence of the given palette. This must be called again whenever the palette is changed.
+		void render(const term::palette<OUT>& palette)
+		{
+			for (size_t i{ 0ull }; i < sequences.size(); ++i) {
+				std::ostringstream ss;
+				ss << palette.set(static_cast<OUT>(i));
+				sequences[i] = std::move(ss).str();
+			}
+			std::ostringstream ss;
+			ss << palette.reset();
+			reset_sequence = std::move(ss).str();
+		}
+
+		/// @brief	Disable every sequence, without changing the palette itself.
+		void clear() noexcept
+		{
+			for (auto& sequence : sequences)
+				sequence.clear();
+			reset_sequence.clear();
+		}
+
+		std::string_view set(const OUT& key) const noexcept { return sequences[static_cast<size_t>(key)]; }
+		std::string_view reset() const noexcept { return reset_sequence; }
+	};
 
 	static struct {
 		///	@brief	Palette instance containing each of the keys from OUT. This is used to allow disabling color sequences program-wide.
@@ -73,6 +111,8 @@ namespace ckconv {
 			std::make_pair(OUT::EQUALS, term::setcolor(color::white)),
 			std::make_pair(OUT::UNITS_SECTION_TEXT, term::setcolor(color::intense_white)),
 		};
+		/// @brief	The sequences of the palette, pre-rendered for the conversion output.
+		RenderedPalette colors{ palette };
 
 
 		std::filesystem::path ini_path;
@@ -81,9 +121,19 @@ namespace ckconv {
 
 		std::streamsize precision{ 6LL };
 		std::streamsize align_to_column{ 8LL };
-		const FmtFlag* notation{ nullptr };
+		Notation notation{ Notation::AUTO };
+		NumberType number_type{ NumberType::LONG_DOUBLE };
 		bool quiet{ false };
 		bool use_full_unit_names{ false };
+
+		// RUNTIME VALUES:
+
+		/// @brief	The number of threads used to format conversions.
+		size_t jobs{ 1ull };
+		/// @brief	When true, values are x,y,z vectors instead of single numbers.
+		bool vector{ false };
+		/// @brief	When true, invalid conversions are reported on STDERR & skipped, instead of stopping the program.
+		bool skip_invalid{ false };
 	} Global;
 
 	/**
@@ -103,6 +153,9 @@ namespace ckconv {
 			<< "USAGE:\n"
 			<< "  " << program_name << " [OPTIONS] [<INPUT_UNIT> <INPUT_VALUE> <OUTPUT_UNIT>]...\n"
 			<< '\n'
+			<< "  The output unit can be a comma-separated list of units, 'all', or 'all:<system>' to convert to several units at once," << '\n'
+			<< "  and may be preceded by '->'; for example: '5 m -> u,ft,cm' or '5 m all:imperial'." << '\n'
+			<< '\n'
 			<< "OPTIONS:\n"
 			<< "  -h            --help            Show the help display and exit." << '\n'
 			<< "  -v            --version         Show the current version number and exit." << '\n'
@@ -114,12 +167,73 @@ namespace ckconv {
 			<< "  -p <#>        --precision <#>   Force show at least <INT> number of digits after the decimal point." << '\n'
 			<< "  -a <#>        --align-to <#>    Aligns output to <#> character columns." << '\n'
 			<< "                                  Does nothing if the quiet option is specified." << '\n'
+			<< "                --precision-mode <MODE>" << '\n'
+			<< "                                  Parse, convert & format numbers as 'float', 'double' or 'long-double'." << '\n'
+			<< "                                  The default is long-double; float & double are faster, but less accurate." << '\n'
 			<< "  -q            --quiet           Print only output values." << '\n'
-			<< "  -n            --no-color        Don't use color escape sequences." << '\n'
+			<< "                --vector          Values are x,y,z vectors written without spaces, such as '1,2.5,-3' or '(1,2.5,-3)'." << '\n'
+			<< "                                  Every component is converted, and the result is written in the same format." << '\n'
+			<< "                --skip-invalid    Report invalid words on STDERR with their positions, and continue from the next valid conversion." << '\n'
+			<< "                --input <FILE>    Read input from <FILE>, after STDIN and before any parameters. May be repeated." << '\n'
+			<< "                --csv <COLUMNS>   Convert columns of CSV input from the first parameter's unit to the second's, instead of" << '\n'
+			<< "                                  reading triples. <COLUMNS> is a comma-separated list of 1-based indices or header names." << '\n'
+			<< "                                  Other fields, quoting & line endings are passed through unchanged." << '\n'
+			<< "                --tsv <COLUMNS>   The same as --csv, for tab-separated input." << '\n'
+			<< "                --binary <TYPE>   Convert raw little-endian arrays of <TYPE> ('f32' or 'f64') from the first parameter's unit" << '\n'
+			<< "                                  to the second's, reading STDIN & input files, and writing to STDOUT." << '\n'
+			<< "                --output <FILE>   Write the output of binary mode to <FILE> instead of STDOUT." << '\n'
+			<< "                --in-place        Overwrite each input file with its converted values in binary mode." << '\n'
+			<< "                --range <START:STOP[:STEP]>" << '\n'
+			<< "                                  Write a table of every value from START to STOP, in steps of STEP (default 1)," << '\n'
+			<< "                                  converted from the first parameter's unit to the second's. Nothing is read from STDIN." << '\n'
+			<< "                --range-format <FORMAT>" << '\n'
+			<< "                                  The format of --range; 'aligned' (the default) or 'csv'." << '\n'
+			<< "                --serve <SOCKET>  Keep running & answer conversion requests on the unix domain socket <SOCKET>." << '\n'
+			<< "                                  Options such as precision, notation, --vector & --skip-invalid apply to every request." << '\n'
+			<< "                                  Responses are never colored." << '\n'
+			<< "                --connect <SOCKET>" << '\n'
+			<< "                                  Send conversions to a server started with --serve, instead of converting them." << '\n'
+			<< "                                  Each line of STDIN, and then all of the parameters, are sent as one request." << '\n'
+			<< "  -j <#>        --jobs <#>        Convert & format on <#> threads, writing output in input order." << '\n'
+			<< "                                  Use 0 for one thread per CPU core. The default is 1." << '\n'
+			<< "                --stats           Print per-stage timings, counters & peak memory usage to STDERR on exit." << '\n'
+			<< "  -n            --no-color        Don't use color escape sequences. They are only used when the output is a terminal." << '\n'
+			<< "                --color           Use color escape sequences, even when the output isn't a terminal." << '\n'
+			<< "                --flush <MODE>    When output is written; after each 'line', in 'block's, or only at 'exit'." << '\n'
+			<< "                                  The default is line when the output is a terminal, and block otherwise." << '\n'
 			<< "                --set-ini         Create or overwrite the config with the current configuration, including options." << '\n'
 			<< "                                  This is affected by other options like precision & no-color." << '\n'
+			<< "                --no-config       Don't read the config. Setting the CKCONV_NO_CONFIG environment variable does the same." << '\n'
 			;
 	}
+	/**
+	 * @brief		Parse the name of a number type, as used by --precision-mode & the config.
+	 * @param name	"float", "double" or "long-double". (case-insensitive)
+	 * @returns		std::optional<NumberType>; std::nullopt when the name is invalid.
+	 */
+	inline std::optional<NumberType> parse_number_type(const std::string& name)
+	{
+		if (const auto lc{ str::tolower(name) }; lc == "float" || lc == "f32")
+			return NumberType::FLOAT;
+		else if (lc == "double" || lc == "f64")
+			return NumberType::DOUBLE;
+		else if (lc == "long-double" || lc == "long double" || lc == "longdouble")
+			return NumberType::LONG_DOUBLE;
+		return std::nullopt;
+	}
+	/// @brief	Get the name of a number type, as accepted by parse_number_type().
+	inline std::string number_type_name(const NumberType& type)
+	{
+		switch (type) {
+		case NumberType::FLOAT:
+			return "float";
+		case NumberType::DOUBLE:
+			return "double";
+		default:
+			return "long-double";
+		}
+	}
+
 	/**
 	 * @brief		Handle all arguments except for help/version.
 	 * @param args	The argument container instance.
@@ -128,9 +242,9 @@ namespace ckconv {
 	{
 		// notation
 		if (args.check_any<opt::Option>("fixed", "standard"))
-			Global.notation = FIXED;
+			Global.notation = Notation::FIXED;
 		else if (args.check_any<opt::Option>("sci", "scientific"))
-			Global.notation = SCIENTIFIC;
+			Global.notation = Notation::SCIENTIFIC;
 
 		// precision
 		if (const auto precision{ args.typegetv_any<opt::Flag, opt::Option>('p', "precision") }; precision.has_value()) {
@@ -148,13 +262,39 @@ namespace ckconv {
 			else throw argument_exception("align-to", "Integer", val, " is not a valid column!");
 		}
 
+		// precision-mode
+		if (const auto mode{ args.typegetv<opt::Option>("precision-mode") }; mode.has_value()) {
+			if (const auto type{ parse_number_type(mode.value()) }; type.has_value())
+				Global.number_type = type.value();
+			else throw argument_exception("precision-mode", "float|double|long-double", mode.value(), " is not a valid precision mode!");
+		}
+
+		// jobs
+		if (const auto jobs{ args.typegetv_any<opt::Flag, opt::Option>('j', "jobs") }; jobs.has_value()) {
+			const auto val{ jobs.value() };
+			if (!val.empty() && std::all_of(val.begin(), val.end(), isdigit)) {
+				Global.jobs = static_cast<size_t>(str::stoll(val));
+				if (Global.jobs == 0ull)
+					Global.jobs = std::max(std::thread::hardware_concurrency(), 1u);
+			}
+			else throw argument_exception("jobs", "Integer", val, " is not a valid number of jobs!");
+		}
+
 		Global.use_full_unit_names = args.check_any<opt::Flag, opt::Option>('f', "full-name");
 
 		// quiet
-		Global.quiet = args.check_any<opt::Flag, opt::Option>('q', "quiet");
+		if (args.check_any<opt::Flag, opt::Option>('q', "quiet"))
+			Global.quiet = true;
 
-		// no-color
-		Global.palette.setActive(!args.check_any<opt::Flag, opt::Option>('n', "no-color"));
+		// vector
+		Global.vector = args.check_any<opt::Option>("vector", "vec");
+
+		// skip-invalid
+		Global.skip_invalid = args.check<opt::Option>("skip-invalid");
+
+		// color; escape sequences are only written to a terminal, unless they are forced on
+		Global.palette.setActive(args.check<opt::Option>("color") || (Global.palette.isActive() && !args.check_any<opt::Flag, opt::Option>('n', "no-color") && is_terminal(1)));
+		Global.colors.render(Global.palette);
 	}
 
 	/**
@@ -175,15 +315,17 @@ namespace ckconv {
 					std::string{ HEADER_OUTPUT }, section{
 						{ "precision", var{ static_cast<file::ini::Integer>(Global.precision) } },
 			{ "notation", var{ []() -> std::string {
-				if (Global.notation != nullptr) {
-					if (Global.notation == FIXED)
-						return "fixed";
-					else if (Global.notation == SCIENTIFIC)
-						return "scientific";
+				switch (Global.notation) {
+				case Notation::FIXED:
+					return "fixed";
+				case Notation::SCIENTIFIC:
+					return "scientific";
+				default:
+					return{};
 				}
-				return{};
 			}()
 			} },
+			{ "precision_mode", var{ number_type_name(Global.number_type) } },
 			{ "quiet", var{ Global.quiet } },
 			{ "no-color", var{ !Global.palette.isActive() } },
 			}
@@ -208,17 +350,32 @@ namespace ckconv {
 	}
 
 	/**
-	 * @brief		Handle setting values from the configuration file.
+	 * @struct	ConfigSnapshot
+	 * @brief	The settings read from the configuration file, already validated so that they can be applied (or cached) without the INI.
+	 */
+	struct ConfigSnapshot {
+		std::optional<std::streamsize> precision;
+		std::optional<Notation> notation;
+		std::optional<NumberType> number_type;
+		bool quiet{ false };
+		bool no_color{ false };
+	};
+
+	/**
+	 * @brief		Read & validate the settings in the configuration file.
 	 * @param ini	The INI config instance.
+	 * @returns		ConfigSnapshot
 	 */
-	inline void handle_config(const file::INI& ini) noexcept(false)
+	inline ConfigSnapshot read_config(const file::INI& ini) noexcept(false)
 	{
+		ConfigSnapshot config;
+
 		// version
 		handle_config_version(ini.getvs(HEADER_GLOBAL, "version").value_or(ckconv_VERSION));
 
 		// precision
 		if (const auto precision{ ini.getv(HEADER_OUTPUT, "precision") }; precision.has_value()) {
-			Global.precision = std::visit([](auto&& val) -> std::streamsize {
+			config.precision = std::visit([](auto&& val) -> std::optional<std::streamsize> {
 				using T = std::decay_t<decltype(val)>;
 				if constexpr (std::same_as<T, file::ini::Integer>)
 					return val;
@@ -227,7 +384,7 @@ namespace ckconv {
 				else if constexpr (std::same_as<T, file::ini::String>)
 					return str::stoll(val);
 				else if constexpr (std::same_as<T, file::ini::Boolean> || std::same_as<T, std::monostate>)
-					return Global.precision;
+					return std::nullopt;
 				else static_assert(var::false_v<T>, "Visitor cannot handle all potential type cases!");
 				}, precision.value());
 		}
@@ -235,29 +392,44 @@ namespace ckconv {
 		// notation
 		if (const auto notation{ ini.getvs(HEADER_OUTPUT, "notation") }; notation.has_value()) {
 			if (const auto lc{ str::tolower(notation.value()) }; lc == "fixed")
-				Global.notation = FIXED;
+				config.notation = Notation::FIXED;
 			else if (lc == "scientific")
-				Global.notation = SCIENTIFIC;
+				config.notation = Notation::SCIENTIFIC;
 		}
 
+		// precision mode
+		if (const auto mode{ ini.getvs(HEADER_OUTPUT, "precision_mode") }; mode.has_value())
+			config.number_type = parse_number_type(mode.value());
+
 		// quiet
-		Global.quiet = ini.checkv(HEADER_OUTPUT, "quiet", true);
+		config.quiet = ini.checkv(HEADER_OUTPUT, "quiet", true);
 
 		// no-color
-		Global.palette.setActive(!ini.checkv(HEADER_OUTPUT, "no-color", true));
+		config.no_color = ini.checkv(HEADER_OUTPUT, "no-color", true);
+
+		return config;
 	}
 
-	inline std::ostream& configure_ostream(std::ostream& os)
+	/// @brief	Apply settings that were read from the configuration file.
+	inline void apply_config(const ConfigSnapshot& config) noexcept
 	{
-		// override floatfield notation
-		if (Global.notation != nullptr)
-			os.setf(*Global.notation);
-
-		// modify precision
-		if (Global.precision != 6ll)
-			os.precision(Global.precision);
+		if (config.precision.has_value())
+			Global.precision = config.precision.value();
+		if (config.notation.has_value())
+			Global.notation = config.notation.value();
+		if (config.number_type.has_value())
+			Global.number_type = config.number_type.value();
+		Global.quiet = config.quiet;
+		Global.palette.setActive(!config.no_color);
+	}
 
-		return os;
+	/**
+	 * @brief		Handle setting values from the configuration file.
+	 * @param ini	The INI config instance.
+	 */
+	inline void handle_config(const file::INI& ini) noexcept(false)
+	{
+		apply_config(read_config(ini));
 	}
 
 	/**
@@ -273,6 +445,16 @@ namespace ckconv {
 			return os << u.getName();
 		return os << u.getSymbol();
 	}
+	/**
+	 * @brief		Stream insertion operator for unit handles, which inserts the unit the same way as operator<<(std::ostream&, const Unit&).
+	 * @param os	Output Stream
+	 * @param id	Length Unit Handle
+	 * @returns		std::ostream&
+	 */
+	inline std::ostream& operator<<(std::ostream& os, const UnitId& id)
+	{
+		return os << getUnit(id);
+	}
 
 	template<SystemID System>
 	struct PrintableMeasurementUnits {
@@ -294,7 +476,7 @@ namespace ckconv {
 					;
 				int power{ -12 };
 				for (const auto& unit : CreationKit.units) {
-					const auto& symbol{ (unit.hasName() ? unit.getSymbol() : ""s) }, name{ unit.getName() };
+					const auto& symbol{ (unit.hasName() ? unit.getSymbol() : std::string_view{}) }, name{ unit.getName() };
 					ss
 						<< "  " << symbol << str::VIndent(symbol_indent_postfix, symbol.size())
 						<< name << str::VIndent(name_indent_postfix, name.size())
@@ -314,7 +496,7 @@ namespace ckconv {
 					;
 				int power{ -12 };
 				for (const auto& unit : Metric.units) {
-					const auto& symbol{ (unit.hasName() ? unit.getSymbol() : ""s) }, name{ unit.getName() };
+					const auto& symbol{ (unit.hasName() ? unit.getSymbol() : std::string_view{}) }, name{ unit.getName() };
 					ss
 						<< "  " << symbol << str::VIndent(symbol_indent_postfix, symbol.size())
 						<< name << str::VIndent(name_indent_postfix, name.size())
@@ -334,7 +516,7 @@ namespace ckconv {
 					<< "  --------------------------------------\n"
 					;
 				for (const auto& unit : Imperial.units) {
-					const auto& symbol{ (unit.hasName() ? unit.getSymbol() : ""s) }, name{ unit.getName() };
+					const auto& symbol{ (unit.hasName() ? unit.getSymbol() : std::string_view{}) }, name{ unit.getName() };
 					ss
 						<< "  " << symbol << str::VIndent(symbol_indent_postfix, symbol.size())
 						<< name << str::VIndent(name_indent_postfix, name.size())
@@ -0,0 +1,179 @@
+/**
+ * @file	MappedFile.hpp
+ * @author	radj307
+ * @brief	Contains a memory-mapped file, which is read-only unless it is opened for writing.
+ */
+#pragma once
+#include "Stats.hpp"
+
+#include <sysarch.h>
+#include <make_exception.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#ifdef OS_WIN
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ckconv {
+	/**
+	 * @class	MappedFile
+	 * @brief	Maps the contents of a file into memory, so it can be read without copying it through stream buffers.
+	 */
+	class MappedFile {
+	public:
+		/**
+		 * @enum	Mode
+		 * @brief	How the file is opened.
+		 */
+		enum class Mode : char {
+			/// @brief	Map an existing file for reading only.
+			READ,
+			/// @brief	Map an existing file for reading & writing. Changes are written back to the file.
+			READ_WRITE,
+			/// @brief	Create or truncate the file to the requested size, and map it for reading & writing.
+			CREATE,
+		};
+
+	private:
+		char* _data{ nullptr };
+		size_t _size{ 0ull };
+		Mode _mode{ Mode::READ };
+		#ifdef OS_WIN
+		HANDLE _file{ INVALID_HANDLE_VALUE }, _mapping{ nullptr };
+		#else
+		int _fd{ -1 };
+		#endif
+
+		void close() noexcept
+		{
+			#ifdef OS_WIN
+			if (_data != nullptr)
+				UnmapViewOfFile(_data);
+			if (_mapping != nullptr)
+				CloseHandle(_mapping);
+			if (_file != INVALID_HANDLE_VALUE)
+				CloseHandle(_file);
+			_file = INVALID_HANDLE_VALUE;
+			_mapping = nullptr;
+			#else
+			if (_data != nullptr)
+				munmap(_data, _size);
+			if (_fd != -1)
+				::close(_fd);
+			_fd = -1;
+			#endif
+			_data = nullptr;
+			_size = 0ull;
+		}
+
+	public:
+		/**
+		 * @brief		Constructor
+		 * @param path	The path of the file to map.
+		 * @param mode	How to open the file.
+		 * @param size	The size to create the file with. Only used by Mode::CREATE.
+		 * @param populate	When true, every page is faulted in when the file is mapped instead of when it is first accessed, where supported (MAP_POPULATE).
+		 *\n				This only helps when the whole mapping is processed at once, as in binary mode; text input is streamed, and leaves it off.
+		 */
+		explicit MappedFile(const std::filesystem::path& path, const Mode& mode = Mode::READ, const size_t& size = 0ull, const bool& populate = false) : _mode{ mode }
+		{
+			// pages are only read when they are first accessed, so most of the reading time is counted towards tokenizing
+			stats::Timer timer{ stats::Stage::READ, true };
+			const bool writable{ mode != Mode::READ };
+			const auto* const kind{ mode == Mode::CREATE ? "output" : "input" };
+			#ifdef OS_WIN
+			_file = CreateFileW(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, writable ? 0 : FILE_SHARE_READ, nullptr, mode == Mode::CREATE ? CREATE_ALWAYS : OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (_file == INVALID_HANDLE_VALUE)
+				throw make_exception("Failed to open ", kind, " file ", path, ": error ", GetLastError());
+			if (mode == Mode::CREATE) {
+				_size = size;
+			}
+			else {
+				LARGE_INTEGER file_size{};
+				if (!GetFileSizeEx(_file, &file_size)) {
+					close();
+					throw make_exception("Failed to get the size of ", kind, " file ", path, ": error ", GetLastError());
+				}
+				_size = static_cast<size_t>(file_size.QuadPart);
+			}
+			if (_size == 0ull) // empty files can't be mapped
+				return;
+			// creating a writable mapping larger than the file extends it
+			_mapping = CreateFileMappingW(_file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, static_cast<DWORD>(static_cast<std::uint64_t>(_size) >> 32u), static_cast<DWORD>(_size & 0xFFFFFFFFull), nullptr);
+			if (_mapping == nullptr || (_data = static_cast<char*>(MapViewOfFile(_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0))) == nullptr) {
+				const auto err{ GetLastError() };
+				close();
+				throw make_exception("Failed to map ", kind, " file ", path, ": error ", err);
+			}
+			#else
+			_fd = ::open(path.c_str(), mode == Mode::CREATE ? (O_RDWR | O_CREAT | O_TRUNC) : writable ? O_RDWR : O_RDONLY, 0666);
+			if (_fd == -1)
+				throw make_exception("Failed to open ", kind, " file ", path, ": error ", errno);
+			if (mode == Mode::CREATE) {
+				if (ftruncate(_fd, static_cast<off_t>(size)) != 0) {
+					const auto err{ errno };
+					close();
+					throw make_exception("Failed to resize output file ", path, ": error ", err);
+				}
+				_size = size;
+			}
+			else {
+				struct stat st {};
+				if (fstat(_fd, &st) != 0) {
+					const auto err{ errno };
+					close();
+					throw make_exception("Failed to get the size of ", kind, " file ", path, ": error ", err);
+				}
+				_size = static_cast<size_t>(st.st_size);
+			}
+			if (_size == 0ull) // empty files can't be mapped
+				return;
+			int flags{ writable ? MAP_SHARED : MAP_PRIVATE };
+			#ifdef MAP_POPULATE
+			// fault every page in with one call, instead of taking a page fault per page while reading
+			if (populate)
+				flags |= MAP_POPULATE;
+			#endif
+			if (void* const data{ mmap(nullptr, _size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, flags, _fd, 0) }; data != MAP_FAILED) {
+				_data = static_cast<char*>(data);
+				// pages that weren't populated are read ahead while they are streamed, and dropped behind
+				if (!populate)
+					madvise(data, _size, MADV_SEQUENTIAL);
+			}
+			else {
+				const auto err{ errno };
+				_size = 0ull;
+				close();
+				throw make_exception("Failed to map ", kind, " file ", path, ": error ", err);
+			}
+			#endif
+			if (mode != Mode::CREATE)
+				stats::count(stats::Counter::BYTES_IN, _size);
+		}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile() noexcept { close(); }
+
+		const char* data() const noexcept { return _data; }
+		/// @brief	Get a pointer to the contents, which can only be written to when the file was opened with Mode::READ_WRITE or Mode::CREATE.
+		char* data() noexcept { return _data; }
+		Mode mode() const noexcept { return _mode; }
+		size_t size() const noexcept { return _size; }
+		/// @brief	Get a view of the entire file.
+		std::string_view view() const noexcept { return{ _data, _size }; }
+	};
+}
@@ -0,0 +1,171 @@
+/**
+ * @file	OutputSink.hpp
+ * @author	radj307
+ * @brief	Contains the OutputSink stream buffer, which writes output directly to a file descriptor in large blocks.
+ */
+#pragma once
+#include "Stats.hpp"
+
+#include <sysarch.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace ckconv {
+	/**
+	 * @enum	FlushMode
+	 * @brief	When buffered output is written to the file descriptor, selected by --flush.
+	 */
+	enum class FlushMode : char {
+		/// @brief	After every complete line. This is the default when the output is a terminal.
+		LINE,
+		/// @brief	Whenever the buffer is full, and whenever the stream is flushed, such as before waiting for more input. This is the default otherwise.
+		BLOCK,
+		/// @brief	Only when the buffer is full, and at exit.
+		EXIT,
+	};
+
+	/**
+	 * @brief		Parse the name of a flush mode, as used by --flush.
+	 * @param name	"line", "block" or "exit".
+	 * @returns		std::optional<FlushMode>; std::nullopt when the name is invalid.
+	 */
+	inline std::optional<FlushMode> parse_flush_mode(const std::string_view& name) noexcept
+	{
+		if (name == "line")
+			return FlushMode::LINE;
+		else if (name == "block")
+			return FlushMode::BLOCK;
+		else if (name == "exit")
+			return FlushMode::EXIT;
+		return std::nullopt;
+	}
+
+	/// @brief	Returns true when the given file descriptor is a terminal.
+	inline bool is_terminal(const int& fd) noexcept
+	{
+		#ifdef OS_WIN
+		return ::_isatty(fd) != 0;
+		#else
+		return ::isatty(fd) != 0;
+		#endif
+	}
+
+	/**
+	 * @class	OutputSink
+	 * @brief	Stream buffer that replaces the buffer of an output stream for its lifetime, and writes everything to a file descriptor with write(2).
+	 *\n		Output is collected into a single large block, so formatting many short lines doesn't make a system call or take a stdio lock for each of them.
+	 *\n		Writes that are larger than the block are passed straight through.
+	 */
+	class OutputSink : public std::streambuf {
+		std::ostream& _os;
+		std::streambuf* _original;
+		int _fd;
+		FlushMode _mode;
+		std::vector<char> _buffer;
+		size_t _size{ 0ull };
+
+		/// @brief	Write a buffer to the file descriptor, retrying partial writes. Returns false if the write failed.
+		bool write_all(const char* data, size_t size) noexcept
+		{
+			stats::Timer timer{ stats::Stage::WRITE, true };
+			while (size > 0ull) {
+				#ifdef OS_WIN
+				const auto count{ ::_write(_fd, data, static_cast<unsigned>(std::min<size_t>(size, 1ull << 30ull))) };
+				#else
+				const auto count{ ::write(_fd, data, size) };
+				#endif
+				if (count < 0) {
+					if (errno == EINTR)
+						continue;
+					return false;
+				}
+				stats::count(stats::Counter::BYTES_OUT, static_cast<std::uint64_t>(count));
+				data += count;
+				size -= static_cast<size_t>(count);
+			}
+			return true;
+		}
+
+		/// @brief	Write the buffered output. Returns false if the write failed.
+		bool write_buffer() noexcept
+		{
+			const auto size{ std::exchange(_size, 0ull) };
+			return write_all(_buffer.data(), size);
+		}
+
+	protected:
+		int_type overflow(int_type ch) override
+		{
+			if (traits_type::eq_int_type(ch, traits_type::eof()))
+				return traits_type::not_eof(ch);
+			if (_size == _buffer.size() && !write_buffer())
+				return traits_type::eof();
+			_buffer[_size++] = traits_type::to_char_type(ch);
+			if (_mode == FlushMode::LINE && traits_type::to_char_type(ch) == '\n' && !write_buffer())
+				return traits_type::eof();
+			return ch;
+		}
+
+		std::streamsize xsputn(const char* s, std::streamsize n) override
+		{
+			const auto size{ static_cast<size_t>(std::max<std::streamsize>(n, 0)) };
+			if (_size + size > _buffer.size()) {
+				if (!write_buffer())
+					return 0;
+				// too large to be worth copying
+				if (size >= _buffer.size())
+					return write_all(s, size) ? n : 0;
+			}
+			std::memcpy(_buffer.data() + _size, s, size);
+			_size += size;
+			if (_mode == FlushMode::LINE && std::memchr(s, '\n', size) != nullptr && !write_buffer())
+				return 0;
+			return n;
+		}
+
+		int sync() override
+		{
+			if (_mode == FlushMode::EXIT)
+				return 0;
+			return write_buffer() ? 0 : -1;
+		}
+
+	public:
+		/// @brief	The default size of the buffer, in bytes.
+		static constexpr const size_t DEFAULT_BUFFER_SIZE{ 1ull << 16ull };
+
+		/**
+		 * @brief				Constructor, which replaces the stream's buffer until this is destroyed.
+		 * @param os			The output stream to redirect, usually std::cout.
+		 * @param fd			The file descriptor to write to.
+		 * @param mode			When output is written. See FlushMode.
+		 * @param buffer_size	The size of the buffer, in bytes.
+		 */
+		OutputSink(std::ostream& os, const int& fd, const FlushMode& mode, const size_t& buffer_size = DEFAULT_BUFFER_SIZE) : _os{ os }, _original{ os.rdbuf() }, _fd{ fd }, _mode{ mode }, _buffer(std::max<size_t>(buffer_size, 1ull))
+		{
+			_os.rdbuf(this);
+		}
+		OutputSink(const OutputSink&) = delete;
+		OutputSink& operator=(const OutputSink&) = delete;
+		/// @brief	Write everything that is still buffered, and restore the stream's original buffer.
+		~OutputSink()
+		{
+			write_buffer();
+			_os.rdbuf(_original);
+		}
+	};
+}
@@ -0,0 +1,277 @@
+/**
+ * @file	Pipeline.hpp
+ * @author	radj307
+ * @brief	Contains the ConversionPipeline class, which turns a stream of words into formatted conversions.
+ */
+#pragma once
+#include "ConversionWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ckconv {
+	/**
+	 * @class	ConversionPipeline
+	 * @brief	Groups words into `<unit> <value> <unit>` or `<value> <unit> <unit>` triples & writes each conversion as soon as its triple is complete.
+	 *\n		The output unit may be a list of targets instead, such as "u,ft,cm" or "all:imperial", which writes a block with one line per target;
+	 *\n		 it may also be preceded by an arrow, as in `5 m -> ft`.
+	 *\n		Words are read in a single pass: each one is parsed as a value or looked up as a unit only when its position in the group calls for it,
+	 *\n		 and the result is kept, so no word is ever parsed or looked up twice.
+	 *\n		This is the same pipeline that ckconv runs on its input, so that it can be reused by the benchmarks.
+	 * @tparam T			The floating-point type that values are parsed, converted & formatted in.
+	 * @tparam ConvertT	The conversion type; BasicConvert<T>, or BasicVectorConvert<T> for vectors.
+	 */
+	template<std::floating_point T = long double, typename ConvertT = BasicConvert<T>>
+	class ConversionPipeline {
+		using ValueT = typename ConvertT::ValueT;
+
+		/**
+		 * @struct	Token
+		 * @brief	A word of the current group, and what it was found to be.
+		 */
+		struct Token {
+			std::string word;
+			/// @brief	The 1-based position of the word in the input.
+			size_t index{ 0ull };
+			ValueT value{};
+			UnitId unit{};
+			/// @brief	The units of a list of targets; the capacity is kept when the token is reused.
+			std::vector<UnitId> targets;
+			/// @brief	Why the word isn't a value, a unit or a list of targets; only meaningful once it has been parsed or looked up.
+			std::optional<Error> value_error, unit_error, targets_error;
+			bool parsed{ false }, looked_up{ false }, listed{ false };
+
+			void assign(const std::string_view& w, const size_t& i)
+			{
+				word = w;
+				index = i;
+				parsed = false;
+				looked_up = false;
+				listed = false;
+			}
+
+			bool is_value() noexcept
+			{
+				if (!parsed) {
+					parsed = true;
+					if (const auto result{ ConvertT::parse_value(word, value) }; !result.has_value())
+						value_error = result.error();
+					else value_error.reset();
+				}
+				return !value_error.has_value();
+			}
+
+			bool is_unit() noexcept
+			{
+				if (!looked_up) {
+					looked_up = true;
+					if (const auto id{ detail::lookup(word) }; id.has_value()) {
+						unit = id.value();
+						unit_error.reset();
+					}
+					else unit_error = id.error();
+				}
+				return !unit_error.has_value();
+			}
+
+			/// @brief	Whether the word is written as a list of target units, such as "u,ft,cm" or "all:imperial", instead of a single unit.
+			bool is_list() const noexcept { return ckconv::is_unit_list(word); }
+
+			/// @brief	Whether the word is a valid list of target units. Only the output unit may be a list.
+			bool is_targets()
+			{
+				if (!listed) {
+					listed = true;
+					stats::Timer timer{ stats::Stage::LOOKUP };
+					if (const auto count{ ckconv::find_units(word, targets) }; count.has_value())
+						targets_error.reset();
+					else targets_error = count.error();
+				}
+				return !targets_error.has_value();
+			}
+
+			/// @brief	Whether the word was meant to be a value, when it is neither a value nor a unit.
+			bool looks_like_value() const noexcept
+			{
+				return !word.empty() && (std::isdigit(static_cast<unsigned char>(word.front())) || word.front() == '-' || word.front() == '+' || word.front() == '.' || word.front() == '(');
+			}
+		};
+
+		ConversionWriter<ConvertT> _writer;
+		/// @brief	The stream that reports of skipped words are written to.
+		std::ostream& _report;
+		/// @brief	The words of the current, incomplete group.
+		std::array<Token, 3ull> _group;
+		size_t _group_size{ 0ull }, _words{ 0ull }, _triples{ 0ull }, _skipped{ 0ull };
+		/// @brief	The run of words that is currently being skipped; it is reported once a conversion follows it, or the pipeline is flushed.
+		struct {
+			size_t first{ 0ull }, last{ 0ull };
+			std::string words;
+			Error error{};
+			std::string error_word;
+		} _skip;
+		/// @brief	Reports of skipped words, which are written to STDERR in blocks.
+		std::string _errors;
+
+		/**
+		 * @brief	Check whether the current group is a valid conversion so far.
+		 * @returns	std::nullopt when the group is valid, or could become valid once it is complete; otherwise the first invalid word.
+		 */
+		std::optional<ParseError> check()
+		{
+			// Group Position:   0         1         2
+			// value first:      value  -> unit   -> unit (or targets)
+			// unit first:       unit   -> value  -> unit (or targets)
+			bool value_first{ false };
+			for (unsigned char i{ 0u }; i < _group_size; ++i) {
+				auto& token{ _group[i] };
+				if (i == 0u) {
+					if (token.is_value())
+						value_first = true;
+					else if (!token.is_unit())
+						return ParseError{ token.looks_like_value() ? *token.value_error : *token.unit_error, i };
+				}
+				else if (i == 1u && !value_first) {
+					if (!token.is_value())
+						return ParseError{ *token.value_error, i };
+				}
+				else if (i == 2u && token.is_list()) {
+					// lists are resolved before any single-unit lookup, which would match a substring of their first target
+					if (!token.is_targets())
+						return ParseError{ *token.targets_error, i };
+				}
+				else if (!token.is_unit())
+					return ParseError{ *token.unit_error, i };
+			}
+			return std::nullopt;
+		}
+
+		/// @brief	Push the conversion described by a complete, valid group.
+		void emit()
+		{
+			_group_size = 0ull;
+			++_triples;
+			stats::count(stats::Counter::TRIPLES);
+			report_skipped();
+			// every word was already classified by check(), so this doesn't parse or look up anything
+			const bool value_first{ _group[0].is_value() };
+			const auto& unit_in{ _group[value_first ? 1ull : 0ull].unit };
+			const auto& value{ _group[value_first ? 0ull : 1ull].value };
+			if (auto& out{ _group[2] }; !out.is_list())
+				_writer.push(ConvertT{ unit_in, value, out.unit, Global.align_to_column });
+			else {
+				// a fan-out conversion; the first target is written with the input, and the rest are aligned beneath it
+				for (size_t i{ 0ull }; i < out.targets.size(); ++i)
+					_writer.push(ConvertT{ unit_in, value, out.targets[i], Global.align_to_column, i > 0ull });
+			}
+		}
+
+		/// @brief	Skip the first word of a group that can't become a valid conversion. The group resumes from the next word, so one stray word doesn't misalign the rest of the input.
+		void skip(const ParseError& err)
+		{
+			const auto& token{ _group[0] };
+			if (_skip.words.empty()) {
+				_skip.first = token.index;
+				_skip.error = err.error;
+				_skip.error_word = _group[err.word].word;
+			}
+			else _skip.words += ' ';
+			// long runs of skipped words are abbreviated
+			if (_skip.words.size() < 64ull)
+				_skip.words += token.word;
+			else if (!_skip.words.ends_with("..."))
+				_skip.words += "...";
+			_skip.last = token.index;
+			std::rotate(_group.begin(), _group.begin() + 1, _group.begin() + static_cast<std::ptrdiff_t>(_group_size));
+			--_group_size;
+		}
+
+		/// @brief	Report the current run of skipped words, if there is one.
+		void report_skipped()
+		{
+			if (_skip.words.empty())
+				return;
+			++_skipped;
+			stats::count(stats::Counter::SKIPPED);
+			if (_skip.first == _skip.last) {
+				_errors += "Skipped word ";
+				_errors += std::to_string(_skip.first);
+			}
+			else {
+				_errors += "Skipped words ";
+				_errors += std::to_string(_skip.first);
+				_errors += '-';
+				_errors += std::to_string(_skip.last);
+			}
+			_errors += " \"";
+			_errors += _skip.words;
+			_errors += "\":  ";
+			_errors += ckconv::error_message(_skip.error);
+			_errors += " \"";
+			_errors += _skip.error_word;
+			_errors += "\"\n";
+			_skip.words.clear();
+			if (_errors.size() >= 4096ull)
+				flush_errors();
+		}
+
+		void flush_errors()
+		{
+			_report.write(_errors.data(), static_cast<std::streamsize>(_errors.size()));
+			_errors.clear();
+		}
+
+	public:
+		/**
+		 * @brief		Constructor.
+		 * @param os	Output stream to write conversions to.
+		 * @param jobs	The number of threads to convert & format on. See ConversionWriter.
+		 * @param report	Output stream to write reports of skipped words to.
+		 */
+		ConversionPipeline(std::ostream& os, const size_t& jobs, std::ostream& report = std::cerr) : _writer{ os, jobs }, _report{ report } {}
+
+		/// @brief	Push the next word of input.
+		void push(const std::string_view& word)
+		{
+			// an arrow may separate the input from the output unit(s)
+			if (_group_size == 2ull && word == "->") {
+				++_words;
+				return;
+			}
+			_group[_group_size++].assign(word, ++_words);
+			for (;;) {
+				if (const auto err{ check() }) {
+					if (!Global.skip_invalid)
+						detail::throw_parse_error(err->error, _group[err->word].word);
+					skip(*err);
+				}
+				else {
+					if (_group_size == _group.size())
+						emit();
+					return;
+				}
+			}
+		}
+
+		/// @brief	Wait for every conversion pushed so far to be written, and write any reports of skipped words.
+		void flush()
+		{
+			_writer.flush();
+			report_skipped();
+			flush_errors();
+		}
+
+		/// @brief	The number of words pushed so far.
+		size_t words() const noexcept { return _words; }
+		/// @brief	The number of valid triples pushed so far.
+		size_t triples() const noexcept { return _triples; }
+		/// @brief	The number of runs of words that were skipped because they weren't part of a valid conversion. Always 0 unless Global.skip_invalid is set.
+		size_t skipped() const noexcept { return _skipped; }
+	};
+}
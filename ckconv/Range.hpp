@@ -0,0 +1,187 @@
+/**
+ * @file	Range.hpp
+ * @author	radj307
+ * @brief	Contains the table generator (--range), which converts a range of values between a pair of units without parsing any input.
+ */
+#pragma once
+#include "Convert.hpp"
+#include "ThreadPool.hpp"
+
+#include <make_exception.hpp>
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ckconv {
+	/**
+	 * @enum	RangeFormat
+	 * @brief	The output format of --range, selected by --range-format.
+	 */
+	enum class RangeFormat : char {
+		/// @brief	One conversion per line, formatted the same way as any other conversion.
+		ALIGNED,
+		/// @brief	A header row with the unit of each column, followed by one "input,output" row per value.
+		CSV,
+	};
+
+	/**
+	 * @brief		Parse the name of a range format, as used by --range-format.
+	 * @param name	"aligned" or "csv".
+	 * @returns		std::optional<RangeFormat>; std::nullopt when the name is invalid.
+	 */
+	inline std::optional<RangeFormat> parse_range_format(const std::string_view& name) noexcept
+	{
+		if (name == "aligned")
+			return RangeFormat::ALIGNED;
+		else if (name == "csv")
+			return RangeFormat::CSV;
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief		Parse a range of values written as "start:stop:step", or "start:stop" with a step of 1.
+	 * @param str	The range.
+	 * @returns		Range<T>
+	 * @throws ex::except	When any part isn't a number, or the step doesn't move from start toward stop.
+	 */
+	template<std::floating_point T>
+	inline Range<T> parse_range(const std::string_view& str)
+	{
+		T parts[3]{ static_cast<T>(0), static_cast<T>(0), static_cast<T>(1) };
+		size_t count{ 0ull };
+		for (size_t begin{ 0ull }; begin <= str.size(); ++count) {
+			auto end{ str.find(':', begin) };
+			if (end == std::string_view::npos)
+				end = str.size();
+			if (count == 3ull)
+				throw make_exception("Invalid range: \"", str, "\"; expected start:stop or start:stop:step");
+			const auto part{ str.substr(begin, end - begin) };
+			if (const auto ec{ parse_number(part, parts[count]) }; ec != std::errc{})
+				throw make_exception("Invalid range: \"", str, "\"; ", error_message(detail::number_error(ec)), " \"", part, '\"');
+			begin = end + 1ull;
+		}
+		if (count < 2ull)
+			throw make_exception("Invalid range: \"", str, "\"; expected start:stop or start:stop:step");
+
+		const Range<T> range{ parts[0], parts[1], parts[2] };
+		if (!range.valid())
+			throw make_exception("Invalid range: \"", str, "\"; the step must be non-zero, and move from start toward stop!");
+		return range;
+	}
+
+	/**
+	 * @class		RangeWriter
+	 * @brief		Writes a conversion table for a range of values, in order.
+	 *\n			The range is split into blocks of rows; each block is filled, converted with one precomputed factor & formatted independently,
+	 *\n			 so with more than one job, blocks are formatted on a thread pool & written in order, the same as ConversionWriter.
+	 * @tparam T	The floating-point type that values are converted & formatted in.
+	 */
+	template<std::floating_point T>
+	class RangeWriter {
+		std::ostream& _os;
+		const UnitId _in, _out;
+		const Range<T> _range;
+		const RangeFormat _format;
+		const size_t _jobs;
+
+		/// @brief	Convert & format a block of rows, appending them to the given string.
+		void format_block(std::string& out, const size_t& first, const size_t& count) const
+		{
+			thread_local std::vector<T> values, results;
+			values.resize(count);
+			results.resize(count);
+			{
+				stats::Timer timer{ stats::Stage::CONVERT, true };
+				convert_range<T>(_in, _range, first, _out, values, results);
+			}
+
+			stats::Timer timer{ stats::Stage::FORMAT, true };
+			const auto precision{ static_cast<int>(Global.precision) };
+			thread_local std::string numbers;
+			for (size_t i{ 0ull }; i < count; ++i) {
+				numbers.clear();
+				if (_format == RangeFormat::CSV || !Global.quiet)
+					append_number(numbers, values[i], precision, Global.notation);
+				const auto input_length{ numbers.size() };
+				append_number(numbers, results[i], precision, Global.notation);
+				const std::string_view formatted{ numbers };
+
+				if (_format == RangeFormat::CSV) {
+					out += formatted.substr(0ull, input_length);
+					out += ',';
+					out += formatted.substr(input_length);
+				}
+				else detail::append_conversion(out, formatted.substr(0ull, input_length), _in, formatted.substr(input_length), _out, Global.align_to_column);
+				out += '\n';
+			}
+		}
+
+		/// @brief	Get the name of a unit, the same way as it is written in conversions.
+		static std::string_view unit_name(const UnitId& id) noexcept
+		{
+			const auto& unit{ getUnit(id) };
+			return Global.use_full_unit_names ? unit.getName() : unit.getSymbol();
+		}
+
+	public:
+		/// @brief	The number of rows in each block.
+		static constexpr const size_t BLOCK_SIZE{ 4096ull };
+
+		/**
+		 * @brief			Constructor.
+		 * @param os		Output stream to write the table to.
+		 * @param in		Input Unit.
+		 * @param range		The range of input values.
+		 * @param out		Output Unit.
+		 * @param format	The output format.
+		 * @param jobs		The number of threads to format on. 0 & 1 both format on the calling thread.
+		 */
+		RangeWriter(std::ostream& os, const UnitId& in, const Range<T>& range, const UnitId& out, const RangeFormat& format, const size_t& jobs = 1ull) : _os{ os }, _in{ in }, _out{ out }, _range{ range }, _format{ format }, _jobs{ jobs } {}
+
+		/// @brief	Write the whole table. Returns the number of rows.
+		size_t write() const
+		{
+			const auto size{ _range.size() };
+			if (_format == RangeFormat::CSV)
+				_os << unit_name(_in) << ',' << unit_name(_out) << '\n';
+
+			if (_jobs <= 1ull) {
+				std::string block;
+				for (size_t first{ 0ull }; first < size; first += BLOCK_SIZE) {
+					block.clear();
+					format_block(block, first, std::min(BLOCK_SIZE, size - first));
+					_os.write(block.data(), static_cast<std::streamsize>(block.size()));
+				}
+			}
+			else {
+				ThreadPool pool{ _jobs };
+				std::deque<std::future<std::string>> pending;
+				const auto write_next{ [&]() {
+					const auto block{ pending.front().get() };
+					pending.pop_front();
+					_os.write(block.data(), static_cast<std::streamsize>(block.size()));
+				} };
+				for (size_t first{ 0ull }; first < size; first += BLOCK_SIZE) {
+					pending.emplace_back(pool.submit([this, first, count = std::min(BLOCK_SIZE, size - first)]() {
+						std::string block;
+						format_block(block, first, count);
+						return block;
+					}));
+					// at most 2 blocks per job are in flight at once, so memory usage is bounded
+					while (pending.size() > _jobs * 2ull)
+						write_next();
+				}
+				while (!pending.empty())
+					write_next();
+			}
+			_os.flush();
+			return size;
+		}
+	};
+}
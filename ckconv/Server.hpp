@@ -0,0 +1,276 @@
+/**
+ * @file	Server.hpp
+ * @author	radj307
+ * @brief	Contains the persistent daemon mode (--serve) & its client (--connect), which communicate over a unix domain socket.
+ *\n
+ *\n		The protocol is line-based:
+ *\n		 - Each request is one line of words, in the same format as the commandline parameters.
+ *\n		   Words are grouped into conversions within each request by the same pipeline as the commandline; groups never span requests.
+ *\n		 - The response contains one line per conversion, then one line per report of skipped words beginning with "?",
+ *\n		   followed by a status line which is either "." followed by the server-side latency in microseconds, or "!" followed by an error message.
+ *\n		   Formatted conversions never begin with '.', '?' or '!', and never contain color escape sequences.
+ */
+#pragma once
+#include "Pipeline.hpp"
+#include "WordReader.hpp"
+
+#include <sysarch.h>
+#include <make_exception.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifndef OS_WIN
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace ckconv::server {
+	#ifndef OS_WIN
+	/**
+	 * @class	LineReader
+	 * @brief	Reads newline-delimited lines from a file descriptor.
+	 */
+	class LineReader {
+		int _fd;
+		std::string _buffer;
+		size_t _pos{ 0ull };
+
+	public:
+		explicit LineReader(const int& fd) : _fd{ fd } {}
+
+		/**
+		 * @brief	Retrieve the next line, excluding the newline.
+		 * @returns	std::optional<std::string_view>; this is only valid until the next call, and is std::nullopt once the input is exhausted.
+		 */
+		std::optional<std::string_view> next()
+		{
+			for (;;) {
+				if (const auto end{ _buffer.find('\n', _pos) }; end != std::string::npos) {
+					const std::string_view line{ _buffer.data() + _pos, end - _pos };
+					_pos = end + 1ull;
+					return line;
+				}
+				_buffer.erase(0ull, _pos);
+				_pos = 0ull;
+
+				char block[4096];
+				const auto count{ ::read(_fd, block, sizeof(block)) };
+				if (count > 0)
+					_buffer.append(block, static_cast<size_t>(count));
+				else if (count == 0 || errno != EINTR) {
+					if (_buffer.empty())
+						return std::nullopt;
+					_pos = _buffer.size(); // return the final unterminated line
+					return std::string_view{ _buffer };
+				}
+			}
+		}
+	};
+
+	/// @brief	Write the entire string to a file descriptor. Returns false if the other end was closed.
+	inline bool write_all(const int& fd, std::string_view str) noexcept
+	{
+		while (!str.empty()) {
+			const auto count{ ::write(fd, str.data(), str.size()) };
+			if (count < 0) {
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+			str.remove_prefix(static_cast<size_t>(count));
+		}
+		return true;
+	}
+
+	/// @brief	Create the address of a unix domain socket.
+	inline sockaddr_un make_address(const std::string& path)
+	{
+		sockaddr_un addr{};
+		if (path.size() >= sizeof(addr.sun_path))
+			throw make_exception("Socket path is too long: \"", path, '\"');
+		addr.sun_family = AF_UNIX;
+		std::memcpy(addr.sun_path, path.c_str(), path.size() + 1ull);
+		return addr;
+	}
+
+	/// @brief	The path of the socket being served, so that it can be removed by the signal handler.
+	inline char served_path[sizeof(sockaddr_un::sun_path)]{};
+
+	/**
+	 * @brief		Answer requests from one client until it disconnects.
+	 * @param fd	The client's socket.
+	 * @param id	The client's number, used for logging.
+	 */
+	inline void handle_client(const int fd, const size_t id)
+	{
+		LineReader reader{ fd };
+		std::ostringstream response, skipped, status, log;
+		for (size_t request{ 1ull }; const auto line{ reader.next() }; ++request) {
+			const auto t0{ std::chrono::steady_clock::now() };
+			response.str({});
+			skipped.str({});
+			status.str({});
+			log.str({});
+			try {
+				// requests are converted by the same pipeline as the commandline, so they accept the same input, such as fan-out targets, --vector & --skip-invalid
+				const auto run_pipeline{ [&line, &response, &skipped]<typename PipelineT>() {
+					PipelineT pipeline{ response, 1ull, skipped };
+					auto words{ line.value() };
+					try {
+						while (const auto word{ next_word(words) })
+							pipeline.push(word.value());
+					} catch (...) {
+						// respond with everything before the failed conversion first, the same as the commandline
+						pipeline.flush();
+						throw;
+					}
+					pipeline.flush();
+					return pipeline.triples();
+				} };
+				const auto conversions{ visit_number_type(Global.number_type, [&run_pipeline]<typename T>() {
+					if (Global.vector)
+						return run_pipeline.template operator()<ConversionPipeline<T, BasicVectorConvert<T>>>();
+					return run_pipeline.template operator()<ConversionPipeline<T>>();
+				}) };
+				const auto latency{ std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() };
+				status << '.' << latency << '\n';
+				log << "client " << id << " request " << request << ": " << conversions << " conversions in " << latency << " us\n";
+			} catch (const std::exception& ex) {
+				status << '!' << ex.what() << '\n';
+				log << "client " << id << " request " << request << ": " << ex.what() << '\n';
+			}
+			// reports of skipped words are sent after the conversions, each on its own line
+			for (auto reports{ skipped.view() }; !reports.empty();) {
+				const auto end{ std::min(reports.find('\n'), reports.size()) };
+				response << '?' << reports.substr(0ull, end) << '\n';
+				reports.remove_prefix(std::min<size_t>(end + 1ull, reports.size()));
+			}
+			response << status.view();
+			// written all at once, so lines from different clients don't interleave
+			std::clog << log.view();
+			if (!write_all(fd, response.view()))
+				break;
+		}
+		::close(fd);
+	}
+	#endif
+
+	/**
+	 * @brief		Listen for requests on a unix domain socket until the process is terminated.
+	 *\n			Each client is served on its own thread, using the current global configuration.
+	 * @param path	The path of the socket to create. A stale socket at this path is replaced, but any other kind of file is left alone & an exception is thrown.
+	 */
+	[[noreturn]] inline void serve(const std::string& path)
+	{
+		#ifdef OS_WIN
+		throw make_exception("--serve is not supported on Windows!");
+		#else
+		const auto addr{ make_address(path) };
+		const int listener{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+		if (listener == -1)
+			throw make_exception("Failed to create socket: error ", errno);
+		// only a socket left behind by a previous server is removed, so a mistyped path can't delete a regular file
+		if (struct stat st; ::lstat(path.c_str(), &st) == 0) {
+			if (!S_ISSOCK(st.st_mode))
+				throw make_exception("Refusing to replace non-socket file \"", path, '\"');
+			::unlink(path.c_str());
+		}
+		if (::bind(listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listener, SOMAXCONN) != 0)
+			throw make_exception("Failed to listen on \"", path, "\": error ", errno);
+
+		// remove the socket when terminated, and don't let disconnected clients kill the server
+		std::memcpy(served_path, addr.sun_path, sizeof(served_path));
+		// the server's own terminal says nothing about where a client writes its output, so responses are plain text
+		Global.colors.clear();
+		const auto on_terminate{ [](int) { ::unlink(served_path); std::_Exit(0); } };
+		std::signal(SIGINT, on_terminate);
+		std::signal(SIGTERM, on_terminate);
+		std::signal(SIGPIPE, SIG_IGN);
+
+		std::clog << "listening on " << path << std::endl;
+		for (size_t id{ 1ull };; ++id) {
+			const int client{ ::accept(listener, nullptr, nullptr) };
+			if (client == -1) {
+				if (errno == EINTR || errno == ECONNABORTED)
+					continue;
+				throw make_exception("Failed to accept a connection: error ", errno);
+			}
+			std::thread(handle_client, client, id).detach();
+		}
+		#endif
+	}
+
+	/**
+	 * @brief				Send requests to a server started with --serve, and print the responses.
+	 * @param path			The path of the server's socket.
+	 * @param has_stdin		When true, each line from STDIN is sent as a separate request.
+	 * @param parameters	Parameters that are sent together as the final request.
+	 * @returns				int; 0 when every request succeeded, otherwise 1.
+	 */
+	inline int connect(const std::string& path, const bool& has_stdin, const std::vector<std::string>& parameters)
+	{
+		#ifdef OS_WIN
+		throw make_exception("--connect is not supported on Windows!");
+		#else
+		const auto addr{ make_address(path) };
+		const int fd{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+		if (fd == -1)
+			throw make_exception("Failed to create socket: error ", errno);
+		if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+			const auto err{ errno };
+			::close(fd);
+			throw make_exception("Failed to connect to \"", path, "\": error ", err);
+		}
+		std::signal(SIGPIPE, SIG_IGN);
+
+		int rc{ 0 };
+		LineReader responses{ fd };
+		// lambda that sends a request & prints the response
+		const auto& request{ [&](const std::string_view& words) {
+			if (!write_all(fd, words) || !write_all(fd, "\n"))
+				throw make_exception("Lost connection to the server!");
+			while (const auto line{ responses.next() }) {
+				if (!line->empty() && line->front() == '.')
+					return;
+				if (!line->empty() && line->front() == '?') {
+					std::cerr << line->substr(1ull) << '\n';
+					continue;
+				}
+				if (!line->empty() && line->front() == '!') {
+					std::cerr << Global.palette.get_error() << line->substr(1ull) << std::endl;
+					rc = 1;
+					return;
+				}
+				std::cout << line.value() << '\n';
+			}
+			throw make_exception("Lost connection to the server!");
+		} };
+
+		if (has_stdin) {
+			LineReader input{ 0 };
+			while (const auto line{ input.next() }) {
+				auto words{ line.value() };
+				if (next_word(words).has_value()) // skip blank lines
+					request(line.value());
+			}
+		}
+		if (!parameters.empty()) {
+			std::string words;
+			for (const auto& param : parameters)
+				(words += param) += ' ';
+			request(words);
+		}
+		::close(fd);
+		return rc;
+		#endif
+	}
+}
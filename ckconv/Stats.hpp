@@ -0,0 +1,398 @@
+/**
+ * @file	Stats.hpp
+ * @author	radj307
+ * @brief	Contains the optional per-stage timers & counters reported by --stats.
+ */
+#pragma once
+#include <sysarch.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <vector>
+
+#ifdef OS_WIN
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <ctime>
+#include <sys/resource.h>
+#endif
+
+namespace ckconv::stats {
+	/// @brief	The stages of the conversion pipeline. Time spent in a nested stage is only counted towards the innermost one.
+	enum class Stage : std::uint8_t {
+		READ,		///< @brief	Reading input from STDIN or files.
+		TOKENIZE,	///< @brief	Splitting input into words.
+		LOOKUP,		///< @brief	Unit lookup.
+		PARSE,		///< @brief	Number parsing.
+		CONVERT,	///< @brief	Converting values.
+		FORMAT,		///< @brief	Formatting conversions.
+		WRITE,		///< @brief	Writing output.
+	};
+	inline constexpr const size_t STAGE_COUNT{ static_cast<size_t>(Stage::WRITE) + 1ull };
+	inline constexpr const char* STAGE_NAMES[STAGE_COUNT]{ "read", "tokenize", "lookup", "parse", "convert", "format", "write" };
+
+	/// @brief	Counted events.
+	enum class Counter : std::uint8_t {
+		TRIPLES,
+		FAILED_LOOKUPS,
+		SKIPPED,
+		BYTES_IN,
+		BYTES_OUT,
+	};
+	inline constexpr const size_t COUNTER_COUNT{ static_cast<size_t>(Counter::BYTES_OUT) + 1ull };
+
+	/**
+	 * @brief	When false, every timer & counter is a single predictable branch.
+	 *\n		This is only set once at startup, before any other threads exist.
+	 */
+	inline bool enabled{ false };
+
+	/// @brief	The CPU time used by the calling thread, in nanoseconds.
+	inline std::uint64_t thread_cpu_ns() noexcept
+	{
+		#ifdef OS_WIN
+		FILETIME creation, exit, kernel, user;
+		if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+			return 0ull;
+		const auto to_ns{ [](const FILETIME& ft) { return ((static_cast<std::uint64_t>(ft.dwHighDateTime) << 32ull) | ft.dwLowDateTime) * 100ull; } };
+		return to_ns(kernel) + to_ns(user);
+		#else
+		timespec ts{};
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+		return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+		#endif
+	}
+
+	/**
+	 * @struct	Accumulator
+	 * @brief	The timers & counters of a single thread. Each thread only ever writes to its own accumulator.
+	 */
+	struct Accumulator {
+		/// @brief	Time measured by sampled timers.
+		std::array<std::uint64_t, STAGE_COUNT> wall_ns{}, cpu_ns{};
+		/// @brief	The number of timers, how many of them were sampled, & how many times sampled timers were paused.
+		std::array<std::uint64_t, STAGE_COUNT> calls{}, sampled{}, paused{};
+		std::array<std::uint64_t, COUNTER_COUNT> counters{};
+	};
+
+	namespace detail {
+		inline std::mutex registry_mutex;
+		/// @brief	Every thread's accumulator. These outlive their threads so that they can be summed at exit.
+		inline std::vector<std::shared_ptr<Accumulator>> registry;
+
+		inline Accumulator& local()
+		{
+			thread_local const std::shared_ptr<Accumulator> acc{ []() {
+				auto ptr{ std::make_shared<Accumulator>() };
+				std::scoped_lock lock{ registry_mutex };
+				registry.emplace_back(ptr);
+				return ptr;
+			}() };
+			return *acc;
+		}
+	}
+
+	/**
+	 * @brief			Increment a counter. Does nothing unless stats are enabled.
+	 * @param counter	The counter to increment.
+	 * @param n			The amount to add.
+	 */
+	inline void count(const Counter& counter, const std::uint64_t& n = 1ull)
+	{
+		if (enabled)
+			detail::local().counters[static_cast<size_t>(counter)] += n;
+	}
+
+	/**
+	 * @class	Timer
+	 * @brief	Scoped timer that adds its lifetime to a pipeline stage. Does nothing unless stats are enabled.
+	 *\n		The enclosing timer on the same thread is paused for the lifetime of a nested one.
+	 *\n		Reading the thread's CPU clock costs about as much as looking up a unit, so only 1 in SAMPLE_INTERVAL
+	 *\n		 outermost timers of each stage are measured, along with everything nested inside them, & the totals
+	 *\n		 are scaled by the number of calls. Timers for rare & expensive stages can be measured every time.
+	 */
+	class Timer {
+		using clock = std::chrono::steady_clock;
+
+		/// @brief	The innermost timer on this thread that is being measured.
+		inline static thread_local Timer* active{ nullptr };
+		/// @brief	The number of unmeasured timers on this thread that are currently alive.
+		inline static thread_local unsigned skipped{ 0u };
+
+		Stage _stage;
+		Accumulator* _acc{ nullptr };
+		bool _measured{ false };
+		Timer* _parent{ nullptr };
+		clock::time_point _wall;
+		std::uint64_t _cpu{ 0ull };
+
+		void start(const clock::time_point& now, const std::uint64_t& cpu) noexcept
+		{
+			_wall = now;
+			_cpu = cpu;
+		}
+		void stop(const clock::time_point& now, const std::uint64_t& cpu) noexcept
+		{
+			const auto i{ static_cast<size_t>(_stage) };
+			_acc->wall_ns[i] += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - _wall).count());
+			_acc->cpu_ns[i] += cpu - _cpu;
+		}
+
+	public:
+		/// @brief	Measure 1 in this many outermost timers of each stage.
+		static constexpr const std::uint64_t SAMPLE_INTERVAL{ 64ull };
+
+		/**
+		 * @brief			Constructor
+		 * @param stage		The stage to add this timer's lifetime to.
+		 * @param always	When true, this timer is always measured instead of being sampled.
+		 */
+		explicit Timer(const Stage& stage, const bool& always = false) : _stage{ stage }
+		{
+			if (!enabled)
+				return;
+			_acc = &detail::local();
+			const auto i{ static_cast<size_t>(_stage) };
+			// timers nested inside a measured timer are always measured, so that it can be paused accurately
+			_measured = always || (skipped == 0u && (active != nullptr || _acc->calls[i] % SAMPLE_INTERVAL == 0ull));
+			++_acc->calls[i];
+			if (!_measured) {
+				++skipped;
+				return;
+			}
+			++_acc->sampled[i];
+			const auto now{ clock::now() };
+			const auto cpu{ thread_cpu_ns() };
+			if ((_parent = active) != nullptr) {
+				_parent->stop(now, cpu);
+				++_acc->paused[static_cast<size_t>(_parent->_stage)];
+			}
+			active = this;
+			start(now, cpu);
+		}
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+		~Timer()
+		{
+			if (_acc == nullptr)
+				return;
+			if (!_measured) {
+				--skipped;
+				return;
+			}
+			const auto now{ clock::now() };
+			const auto cpu{ thread_cpu_ns() };
+			stop(now, cpu);
+			active = _parent;
+			if (_parent != nullptr)
+				_parent->start(now, cpu);
+		}
+	};
+
+	/**
+	 * @class	CountingBuffer
+	 * @brief	Stream buffer that forwards everything to another buffer in large blocks, counting the bytes & timing the writes.
+	 */
+	class CountingBuffer : public std::streambuf {
+		std::streambuf* _sink;
+		std::vector<char> _buffer;
+
+		/// @brief	Write the buffered output to the sink.
+		bool flush_buffer()
+		{
+			const auto size{ pptr() - pbase() };
+			if (size == 0)
+				return true;
+			Timer timer{ Stage::WRITE, true };
+			const auto written{ _sink->sputn(pbase(), size) };
+			count(Counter::BYTES_OUT, static_cast<std::uint64_t>(std::max<std::streamsize>(written, 0)));
+			setp(_buffer.data(), _buffer.data() + _buffer.size());
+			return written == size;
+		}
+
+	protected:
+		int_type overflow(int_type ch) override
+		{
+			if (!flush_buffer())
+				return traits_type::eof();
+			if (!traits_type::eq_int_type(ch, traits_type::eof()))
+				return sputc(traits_type::to_char_type(ch));
+			return traits_type::not_eof(ch);
+		}
+		int sync() override
+		{
+			if (!flush_buffer())
+				return -1;
+			Timer timer{ Stage::WRITE, true };
+			return _sink->pubsync();
+		}
+
+	public:
+		explicit CountingBuffer(std::streambuf* sink, const size_t& buffer_size = 1ull << 16ull) : _sink{ sink }, _buffer(std::max<size_t>(buffer_size, 1ull))
+		{
+			setp(_buffer.data(), _buffer.data() + _buffer.size());
+		}
+	};
+
+	namespace detail {
+		/// @brief	The time that reading the clocks adds to each measured interval, in nanoseconds.
+		inline std::uint64_t overhead_wall_ns{ 0ull }, overhead_cpu_ns{ 0ull };
+
+		/// @brief	Measure the overhead of an empty timer, so that it can be subtracted from each measured interval.
+		inline void calibrate()
+		{
+			constexpr std::uint64_t ITERATIONS{ 1000ull };
+			auto& acc{ local() };
+			const auto i{ static_cast<size_t>(Stage::READ) };
+			const auto wall{ acc.wall_ns[i] }, cpu{ acc.cpu_ns[i] }, calls{ acc.calls[i] }, sampled{ acc.sampled[i] };
+			for (std::uint64_t n{ 0ull }; n < ITERATIONS; ++n)
+				Timer timer{ Stage::READ, true };
+			overhead_wall_ns = (acc.wall_ns[i] - wall) / ITERATIONS;
+			overhead_cpu_ns = (acc.cpu_ns[i] - cpu) / ITERATIONS;
+			acc.wall_ns[i] = wall;
+			acc.cpu_ns[i] = cpu;
+			acc.calls[i] = calls;
+			acc.sampled[i] = sampled;
+		}
+	}
+
+	/// @brief	The peak resident set size of this process, in bytes.
+	inline std::uint64_t peak_rss() noexcept
+	{
+		#ifdef OS_WIN
+		PROCESS_MEMORY_COUNTERS pmc{};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+			return static_cast<std::uint64_t>(pmc.PeakWorkingSetSize);
+		return 0ull;
+		#else
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		#ifdef __APPLE__
+		return static_cast<std::uint64_t>(usage.ru_maxrss);
+		#else
+		return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024ull;
+		#endif
+		#endif
+	}
+
+	/// @brief	The CPU time used by every thread of this process, in nanoseconds.
+	inline std::uint64_t process_cpu_ns() noexcept
+	{
+		#ifdef OS_WIN
+		FILETIME creation, exit, kernel, user;
+		if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+			return 0ull;
+		const auto to_ns{ [](const FILETIME& ft) { return ((static_cast<std::uint64_t>(ft.dwHighDateTime) << 32ull) | ft.dwLowDateTime) * 100ull; } };
+		return to_ns(kernel) + to_ns(user);
+		#else
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		const auto to_ns{ [](const timeval& tv) { return static_cast<std::uint64_t>(tv.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(tv.tv_usec) * 1000ull; } };
+		return to_ns(usage.ru_utime) + to_ns(usage.ru_stime);
+		#endif
+	}
+
+	/**
+	 * @brief			Write the report of every thread's timers & counters.
+	 *\n				Every thread that recorded anything must have finished its work first.
+	 * @param os		Output stream.
+	 * @param elapsed	Wall time since the program started.
+	 */
+	inline void report(std::ostream& os, const std::chrono::steady_clock::duration& elapsed)
+	{
+		Accumulator total;
+		{
+			std::scoped_lock lock{ detail::registry_mutex };
+			for (const auto& acc : detail::registry) {
+				for (size_t i{ 0ull }; i < STAGE_COUNT; ++i) {
+					total.wall_ns[i] += acc->wall_ns[i];
+					total.cpu_ns[i] += acc->cpu_ns[i];
+					total.calls[i] += acc->calls[i];
+					total.sampled[i] += acc->sampled[i];
+					total.paused[i] += acc->paused[i];
+				}
+				for (size_t i{ 0ull }; i < COUNTER_COUNT; ++i)
+					total.counters[i] += acc->counters[i];
+			}
+		}
+		const auto ms{ [](const std::uint64_t& ns) { return static_cast<double>(ns) / 1e6; } };
+		// estimate the total time of each stage from its sampled timers, without the overhead of reading the clocks
+		const auto estimate{ [&total](const std::array<std::uint64_t, STAGE_COUNT>& ns, const std::uint64_t& overhead, const size_t& i) -> std::uint64_t {
+			if (total.sampled[i] == 0ull)
+				return 0ull;
+			const auto measured{ static_cast<double>(ns[i]) - static_cast<double>(overhead * (total.sampled[i] + total.paused[i])) };
+			return static_cast<std::uint64_t>(std::max(measured, 0.0) * (static_cast<double>(total.calls[i]) / static_cast<double>(total.sampled[i])));
+		} };
+		const auto counter{ [&total](const Counter& c) { return total.counters[static_cast<size_t>(c)]; } };
+
+		std::ostringstream ss;
+		ss << std::fixed << std::setprecision(3)
+			<< "ckconv stats: (stage times are estimated from 1 in " << Timer::SAMPLE_INTERVAL << " calls)\n"
+			<< "  stage       wall (ms)     cpu (ms)        calls\n"
+			<< "  -----------------------------------------------\n";
+		for (size_t i{ 0ull }; i < STAGE_COUNT; ++i) {
+			ss << "  " << std::left << std::setw(10) << STAGE_NAMES[i] << std::right
+				<< std::setw(11) << ms(estimate(total.wall_ns, detail::overhead_wall_ns, i))
+				<< std::setw(13) << ms(estimate(total.cpu_ns, detail::overhead_cpu_ns, i))
+				<< std::setw(13) << total.calls[i] << '\n';
+		}
+		ss
+			<< "  -----------------------------------------------\n"
+			<< "  total     " << std::setw(11) << ms(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()))
+			<< std::setw(13) << ms(process_cpu_ns()) << '\n'
+			<< '\n'
+			<< "  triples         " << counter(Counter::TRIPLES) << '\n'
+			<< "  failed lookups  " << counter(Counter::FAILED_LOOKUPS) << '\n'
+			<< "  skipped         " << counter(Counter::SKIPPED) << '\n'
+			<< "  bytes in        " << counter(Counter::BYTES_IN) << '\n'
+			<< "  bytes out       " << counter(Counter::BYTES_OUT) << '\n'
+			<< "  peak RSS        " << (peak_rss() / 1024ull) << " KiB\n";
+		os << ss.str() << std::flush;
+	}
+
+	/**
+	 * @class	Session
+	 * @brief	Enables stats for its lifetime, and writes the report when destroyed.
+	 *\n		Bytes written to the output are counted by the stream buffer that writes them, such as OutputSink or CountingBuffer.
+	 */
+	class Session {
+		std::chrono::steady_clock::time_point _start;
+		std::ostream& _os, & _report;
+
+	public:
+		/**
+		 * @brief			Constructor. This must be called before any other threads are started.
+		 * @param start		The time that the program started.
+		 * @param os		The output stream that is flushed before the report is written, so that every write is counted.
+		 * @param report	The output stream to write the report to.
+		 */
+		Session(const std::chrono::steady_clock::time_point& start, std::ostream& os, std::ostream& report) : _start{ start }, _os{ os }, _report{ report }
+		{
+			enabled = true;
+			detail::calibrate();
+		}
+		Session(const Session&) = delete;
+		Session& operator=(const Session&) = delete;
+		~Session()
+		{
+			_os.flush();
+			stats::report(_report, std::chrono::steady_clock::now() - _start);
+			enabled = false;
+		}
+	};
+}
@@ -0,0 +1,91 @@
+/**
+ * @file	ThreadPool.hpp
+ * @author	radj307
+ * @brief	Contains a minimal fixed-size thread pool.
+ */
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ckconv {
+	/**
+	 * @class	ThreadPool
+	 * @brief	Runs submitted tasks on a fixed number of worker threads, in submission order.
+	 */
+	class ThreadPool {
+		std::vector<std::thread> _workers;
+		std::queue<std::function<void()>> _tasks;
+		std::mutex _mutex;
+		std::condition_variable _cv;
+		bool _stop{ false };
+
+		void work()
+		{
+			for (;;) {
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_cv.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+					if (_tasks.empty()) // only true when stopping
+						return;
+					task = std::move(_tasks.front());
+					_tasks.pop();
+				}
+				task();
+			}
+		}
+
+	public:
+		/**
+		 * @brief			Constructor
+		 * @param threads	The number of worker threads to start.
+		 */
+		explicit ThreadPool(const size_t& threads)
+		{
+			_workers.reserve(threads);
+			for (size_t i{ 0ull }; i < threads; ++i)
+				_workers.emplace_back(&ThreadPool::work, this);
+		}
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		/// @brief	Destructor; finishes all queued tasks, then joins the worker threads.
+		~ThreadPool()
+		{
+			{
+				std::scoped_lock<std::mutex> lock(_mutex);
+				_stop = true;
+			}
+			_cv.notify_all();
+			for (auto& worker : _workers)
+				worker.join();
+		}
+
+		/// @brief	Get the number of worker threads.
+		size_t size() const noexcept { return _workers.size(); }
+
+		/**
+		 * @brief		Queue a task to run on a worker thread.
+		 * @param func	A callable that takes no arguments.
+		 * @returns		std::future that receives the task's result, or any exception that it throws.
+		 */
+		template<typename F>
+		std::future<std::invoke_result_t<F>> submit(F&& func)
+		{
+			auto task{ std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(func)) };
+			auto future{ task->get_future() };
+			{
+				std::scoped_lock<std::mutex> lock(_mutex);
+				_tasks.emplace([task]() { (*task)(); });
+			}
+			_cv.notify_one();
+			return future;
+		}
+	};
+}
@@ -0,0 +1,161 @@
+/**
+ * @file	WordReader.hpp
+ * @author	radj307
+ * @brief	Contains a streaming, whitespace-delimited word reader with bounded memory usage.
+ */
+#pragma once
+#include "Stats.hpp"
+
+#include <sysarch.h>
+#include <make_exception.hpp>
+
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include <cerrno>
+
+#ifdef OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace ckconv {
+	/// @brief	Returns true when the given character separates words.
+	inline constexpr bool is_word_delimiter(const char& ch) noexcept
+	{
+		return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r';
+	}
+
+	/**
+	 * @brief			Retrieve the next word from a buffer that is entirely in memory, without copying it.
+	 * @param buffer	The remaining buffer. The word & any delimiters before it are removed from the front.
+	 * @returns			std::optional<std::string_view>; std::nullopt once the buffer contains no more words.
+	 */
+	inline std::optional<std::string_view> next_word(std::string_view& buffer) noexcept
+	{
+		stats::Timer timer{ stats::Stage::TOKENIZE };
+		size_t begin{ 0ull };
+		while (begin < buffer.size() && is_word_delimiter(buffer[begin]))
+			++begin;
+		if (begin == buffer.size()) {
+			buffer = {};
+			return std::nullopt;
+		}
+		auto end{ begin };
+		while (end < buffer.size() && !is_word_delimiter(buffer[end]))
+			++end;
+		const auto word{ buffer.substr(begin, end - begin) };
+		buffer.remove_prefix(end);
+		return word;
+	}
+
+	/**
+	 * @class	WordReader
+	 * @brief	Reads whitespace-delimited words from a file descriptor in large blocks.
+	 *\n		Only one block is buffered at a time, so memory usage does not depend on the size of the input;
+	 *\n		 the buffer only grows if a single word is longer than the block size.
+	 */
+	class WordReader {
+		int _fd;
+		std::vector<char> _buffer;
+		size_t _pos{ 0ull }, _end{ 0ull };
+		bool _eof{ false };
+		std::ostream* _tied{ nullptr };
+
+		/// @brief	Move any unconsumed bytes to the front of the buffer, then read another block. Returns false at EOF.
+		bool fill()
+		{
+			if (_pos > 0ull) {
+				std::copy(_buffer.begin() + _pos, _buffer.begin() + _end, _buffer.begin());
+				_end -= _pos;
+				_pos = 0ull;
+			}
+			if (_end == _buffer.size()) // a single word filled the whole buffer
+				_buffer.resize(_buffer.size() * 2ull);
+
+			// flush the tied stream so output isn't held back while waiting for input
+			if (_tied != nullptr)
+				_tied->flush();
+
+			stats::Timer timer{ stats::Stage::READ, true };
+			for (;;) {
+				#ifdef OS_WIN
+				const auto count{ ::_read(_fd, _buffer.data() + _end, static_cast<unsigned>(_buffer.size() - _end)) };
+				#else
+				const auto count{ ::read(_fd, _buffer.data() + _end, _buffer.size() - _end) };
+				#endif
+				if (count > 0) {
+					stats::count(stats::Counter::BYTES_IN, static_cast<std::uint64_t>(count));
+					_end += static_cast<size_t>(count);
+					return true;
+				}
+				else if (count == 0) {
+					_eof = true;
+					return false;
+				}
+				else if (errno != EINTR)
+					throw make_exception("Failed to read input: error ", errno);
+			}
+		}
+
+	public:
+		/// @brief	The default number of bytes read at a time.
+		static constexpr const size_t DEFAULT_BLOCK_SIZE{ 1ull << 16ull };
+
+		/**
+		 * @brief				Constructor
+		 * @param fd			File descriptor to read from.
+		 * @param block_size	The number of bytes to read at a time.
+		 */
+		WordReader(const int& fd, const size_t& block_size = DEFAULT_BLOCK_SIZE) : _fd{ fd }, _buffer(std::max<size_t>(block_size, 1ull)) {}
+
+		/**
+		 * @brief		Flush the given output stream before blocking on a read, the same way std::cin is tied to std::cout.
+		 * @param os	Pointer to an output stream, or nullptr to untie.
+		 */
+		void tie(std::ostream* os) noexcept { _tied = os; }
+
+		/**
+		 * @brief	Retrieve the next word from the input.
+		 * @returns	std::optional<std::string_view>; this is only valid until the next call, and is std::nullopt once the input is exhausted.
+		 */
+		std::optional<std::string_view> next()
+		{
+			stats::Timer timer{ stats::Stage::TOKENIZE };
+			for (;;) {
+				// skip delimiters
+				while (_pos < _end && is_word_delimiter(_buffer[_pos]))
+					++_pos;
+				// find the end of the word
+				auto word_end{ _pos };
+				while (word_end < _end && !is_word_delimiter(_buffer[word_end]))
+					++word_end;
+
+				if (word_end < _end || (_eof && word_end > _pos)) {
+					const std::string_view word{ _buffer.data() + _pos, word_end - _pos };
+					_pos = word_end;
+					return word;
+				}
+				if (_eof || !fill())
+					return std::nullopt;
+			}
+		}
+
+		/**
+		 * @brief	Retrieve all of the buffered input that hasn't been consumed yet, reading another block if there is none.
+		 *\n		This is used by readers that need to see every byte, including delimiters.
+		 * @returns	std::optional<std::string_view>; this is only valid until the next call, and is std::nullopt once the input is exhausted.
+		 */
+		std::optional<std::string_view> next_block()
+		{
+			if (_pos == _end && (_eof || !fill()))
+				return std::nullopt;
+			const std::string_view block{ _buffer.data() + _pos, _end - _pos };
+			_pos = _end;
+			return block;
+		}
+	};
+}
@@ -1,142 +1,33 @@
 #include "conv.hpp"
 #include "Global.h"
+#include "Convert.hpp"
+#include "Pipeline.hpp"
+#include "WordReader.hpp"
+#include "MappedFile.hpp"
+#include "Server.hpp"
+#include "Csv.hpp"
+#include "Binary.hpp"
+#include "Stats.hpp"
+#include "OutputSink.hpp"
+#include "ConfigCache.hpp"
+#include "Range.hpp"
 using namespace ckconv;
 
-#include <math.hpp>
 #include <envpath.hpp>
 #include <hasPendingDataSTDIN.h>
 
 /**
- * @struct	Convert
- * @brief	Performs a single conversion operation, and exposes std::ostream operator<<() to format and insert it into an output stream.
+ * @brief		Get the location of the config file.
+ *\n			The program's location is only resolved from the PATH on Windows, where the config is stored beside the executable.
+ * @param argv0	The first argument passed to the program.
  */
-struct Convert {
-	/// @brief	String Tuple
-	using Tuple = std::tuple<ckconv::Unit, long double, ckconv::Unit>;
-	using StrTuple = std::tuple<std::string, std::string, std::string>;
-	using NumberT = long double;
-private:
-	Tuple _vars;
-	std::streamsize _min_indent{ 0ull };
-
-	///	@brief	Sorts the first & second arguments so that they are in the correct order when passed to the converter. Also removes any commas.
-	static inline Tuple convert_tuple(std::tuple<std::string, std::string, std::string>&& tpl)
-	{
-		auto& [first, second, third] { tpl };
-
-		// swap the first & second args if the first argument is the value
-		if (std::all_of(first.begin(), first.end(), [](auto&& ch) { return isdigit(ch) || ch == '.' || ch == '-' || ch == ','; })) {
-			const auto copy{ second };
-			second = str::strip(first, ',');
-			first = copy;
-		}
-		else second = str::strip(second, ',');
-
-		return{ ckconv::getUnit(first), str::stold(second), ckconv::getUnit(third) };
-	}
-
-	///	@brief	Returns the result of the conversion.
-	static inline NumberT getResult(const ckconv::Unit& input_unit, const NumberT& input, const ckconv::Unit& output_unit) noexcept(false)
-	{
-		if (math::equal(input, 0.0l)) // if input is 0, short-circuit and return 0
-			return 0.0l;
-		if (input_unit == output_unit)
-			return input;
-		return ckconv::convert(input_unit, input, output_unit);
-	}
-
-public:
-	/// @brief	Default constructor
-	Convert(std::tuple<std::string, std::string, std::string>&& vars, const std::streamsize& min_indent = 0ull) : _vars{ std::move(convert_tuple(std::move(vars))) }, _min_indent{ min_indent } {}
-	/**
-	 * @brief			Constructor
-	 * @param unit_in	Input Unit (OR Input Value, if val_in is the input unit)
-	 * @param val_in	Input Value (OR Input Unit, if unit_in is the input value)
-	 * @param unit_out	Output Unit
-	 */
-	Convert(const std::string& unit_in, const std::string& val_in, const std::string& unit_out, const std::streamsize& min_indent = 0ull) : Convert(std::move(std::make_tuple(unit_in, val_in, unit_out)), min_indent) {}
-
-	NumberT operator()() const { return getResult(std::get<0>(_vars), std::get<1>(_vars), std::get<2>(_vars)); }
-
-	/**
-	 * @brief	Format and print the result of the conversion to the given ostream instance.
-	 *\n		This may change the floatfield and/or precision of the output stream.
-	 * @returns	std::ostream&
-	 */
-	friend std::ostream& operator<<(std::ostream& os, const Convert& conv)
-	{
-		using ckconv::operator<<;
-		// get inputs
-		const auto& [input_unit, input, output_unit] {conv._vars};
-
-		if (!Global.quiet) {
-			const auto
-				input_unit_str{ str::stringify(configure_ostream, input_unit) },
-				input_str{ str::stringify(configure_ostream, input) };
-
-			os // insert input
-				<< Global.palette.set(OUT::INPUT_VALUE) << input_str << Global.palette.reset()
-				<< ' '
-				<< Global.palette.set(OUT::INPUT_UNIT) << input_unit_str << Global.palette.reset()
-				<< str::VIndent(conv._min_indent, (input_str.size() + input_unit_str.size() + 1ull))
-				<< Global.palette.set(OUT::EQUALS) << '=' << Global.palette.reset() << ' ';
-		}
-
-		const NumberT output{ conv.getResult(input_unit, input, output_unit) };
-		const auto output_str{ str::stringify(configure_ostream, output) };
-
-		os << Global.palette.set(OUT::OUTPUT_VALUE) << output_str << Global.palette.reset();
-
-		if (!Global.quiet)
-			os << ' ' << Global.palette.set(OUT::OUTPUT_UNIT) << output_unit << Global.palette.reset();
-
-		return os;
-	}
-};
-
-/**
- * @brief	Read all available input from STDIN.
- * @returns	std::vector<std::string>
- */
-INLINE std::vector<std::string> read_words_stdin()
-{
-	// lambda that gets the next word from STDIN
-	const auto& getNextWord{ [&]() -> std::string {
-		std::string s;
-		if (std::cin.good())
-			str::getline(std::cin, s, ' ', '\n', '\t');
-		return s;
-	} };
-	std::vector<std::string> vec;
-	vec.reserve(24);
-	while (std::cin.good() && hasPendingDataSTDIN())
-		if (auto word{ getNextWord() }; !word.empty())
-			vec.emplace_back(std::move(word));
-	vec.shrink_to_fit();
-	return vec;
-}
-
-/**
- * @brief		Concatenate 2 string vectors.
- * @param fst	First Vector
- * @param snd	Second Vector
- * @returns		std::vector<std::string>
- */
-template<typename T> [[nodiscard]]
-INLINE std::vector<T> catvec(const std::vector<T>& fst, const std::vector<T>& snd)
-{
-	std::vector<T> vec;
-	vec.reserve(fst.size() + snd.size());
-	for (auto& it : fst)
-		vec.emplace_back(it);
-	for (auto& it : snd)
-		vec.emplace_back(it);
-	vec.shrink_to_fit();
-	return vec;
-}
-
-INLINE std::filesystem::path getConfigDir(std::filesystem::path program_dir, std::filesystem::path program_name)
+INLINE std::filesystem::path getConfigDir(const char* argv0)
 {
+	#ifdef OS_WIN
+	const auto [program_dir, program_name] { env::PATH().resolve_split(argv0) };
+	#else
+	const auto program_name{ std::filesystem::path{ argv0 }.filename() };
+	#endif
 	std::string env_var_name{ str::toupper(std::filesystem::path(program_name).replace_extension().generic_string()) + "_CONFIG_DIR" };
 	if (const auto var{ env::getvar(env_var_name) }; var.has_value())
 		return var.value();
@@ -151,36 +42,55 @@ INLINE std::filesystem::path getConfigDir(std::filesystem::path program_dir, std
 	#endif
 }
 
+/// @brief	Returns true when the config is disabled by the CKCONV_NO_CONFIG environment variable, which is set to anything except "" or "0".
+INLINE bool isConfigDisabledByEnv()
+{
+	const auto var{ env::getvar("CKCONV_NO_CONFIG") };
+	return var.has_value() && !var.value().empty() && var.value() != "0";
+}
+
 int main(const int argc, char** argv)
 {
+	const auto start_time{ std::chrono::steady_clock::now() };
+	// reports stats when it goes out of scope, after every other thread has finished
+	std::optional<stats::Session> stats_session;
+	// buffers everything written to STDOUT, and writes it with write(2) according to --flush
+	// this is destroyed before stats_session, so output that is still buffered (such as with --flush exit) is written & counted before the report
+	std::optional<OutputSink> output;
 	int rc{ -1 };
 	try {
 		// parse arguments
-		opt::ParamsAPI2 args{ argc, argv, 'p', "precision", 'a', "align-to" };
-		// find the program's location
-		const auto [program_path, program_name] { env::PATH().resolve_split(argv[0]) };
-
-		std::vector<std::string> parameters{ args.typegetv_all<opt::Parameter>() };
-		if (hasPendingDataSTDIN())
-			parameters = catvec(read_words_stdin(), parameters);
+		opt::ParamsAPI2 args{ argc, argv, 'p', "precision", 'a', "align-to", 'j', "jobs", "input", "serve", "connect", "precision-mode", "csv", "tsv", "binary", "output", "flush", "range", "range-format" };
+		if (const auto flush{ args.typegetv<opt::Option>("flush") }; flush.has_value()) {
+			const auto mode{ parse_flush_mode(flush.value()) };
+			if (!mode.has_value())
+				throw argument_exception("flush", "line|block|exit", flush.value(), " is not a valid flush mode!");
+			output.emplace(std::cout, 1, mode.value());
+		}
+		else output.emplace(std::cout, 1, is_terminal(1) ? FlushMode::LINE : FlushMode::BLOCK);
+		if (args.check<opt::Option>("stats"))
+			stats_session.emplace(start_time, std::cout, std::cerr);
+		// the program's location is only resolved for the help & version displays
+		const auto program_name{ [&argv]() { return env::PATH().resolve_split(argv[0]).second.generic_string(); } };
 
-		// Set the ini path
-		Global.ini_path = getConfigDir(program_path, program_name);
+		const std::vector<std::string> parameters{ args.typegetv_all<opt::Parameter>() }, input_files{ args.typegetv_all<opt::Option>("input") };
+		const bool has_stdin{ hasPendingDataSTDIN() };
 
 		// handle help argument
-		if ((args.empty() && parameters.empty()) || args.check_any<opt::Flag, opt::Option>('h', "help")) {
-			write_help(std::cout, program_name.generic_string());
+		if ((args.empty() && !has_stdin) || args.check_any<opt::Flag, opt::Option>('h', "help")) {
+			write_help(std::cout, program_name());
 			return 0;
 		}
 		// handle version argument
 		else if (args.check_any<opt::Flag, opt::Option>('v', "version")) {
 			if (!args.check_any<opt::Flag, opt::Option>('q', "quiet"))
-				std::cout << program_name.generic_string() << " v";
+				std::cout << program_name() << " v";
 			std::cout << ckconv_VERSION << std::endl;
 			return 0;
 		}
 		// set ini
 		else if (args.check_any<opt::Option>("set-ini", "ini-set")) {
+			Global.ini_path = getConfigDir(argv[0]);
 			handle_args(args);
 			write_settings_to_config();
 			return 0;
@@ -188,52 +98,156 @@ int main(const int argc, char** argv)
 		// list units
 		else if (args.check_any<opt::Flag, opt::Option>('u', "units")) {
 			if (const auto& units{ args.typegetv_any<opt::Flag, opt::Option>('u', "units") }; units.has_value()) {
-				const auto s{ str::tolower(units.value()) };
-				if (s == "m" || s == "metric") {
+				switch (ckconv::find_system(units.value()).value_or(SystemID::ALL)) {
+				case SystemID::METRIC:
 					std::cout << ckconv::PrintableMeasurementUnits<SystemID::METRIC>() << std::endl;
 					return 0;
-				}
-				else if (s == "i" || s == "imperial") {
+				case SystemID::IMPERIAL:
 					std::cout << ckconv::PrintableMeasurementUnits<SystemID::IMPERIAL>() << std::endl;
 					return 0;
-				}
-				else if (s == "creationkit" || s == "creation kit" || s == "ck" || s == "gamebryo" || s == "engine" || s == "unit" || s == "units" || s == "un" || s == "u") {
+				case SystemID::CREATIONKIT:
 					std::cout << ckconv::PrintableMeasurementUnits<SystemID::CREATIONKIT>() << std::endl;
 					return 0;
+				default:
+					break;
 				}
 			}
 			std::cout << ckconv::PrintableMeasurementUnits<SystemID::ALL>() << std::endl;
 			return 0;
 		}
 
-		// read the ini if it exists
-		if (file::exists(Global.ini_path))
-			handle_config(file::INI(Global.ini_path));
+		// read the config, unless it can't affect the output or it is disabled; a validated snapshot is cached until the INI is modified
+		if (!args.check_any<opt::Option>("binary", "connect", "no-config") && !isConfigDisabledByEnv()) {
+			Global.ini_path = getConfigDir(argv[0]);
+			if (const auto config{ config::load(Global.ini_path) }; config.has_value())
+				apply_config(config.value());
+		}
 
 		handle_args(args);
 
-		// Hidden debug option to dump all parameters to STDOUT
-		if (args.check<opt::Option>("debug-dump-all")) {
-			for (auto& it : parameters)
-				std::cout << Global.palette.get_debug() << '\"' << it << "\"\n";
+		// daemon mode
+		if (const auto socket_path{ args.typegetv<opt::Option>("serve") }; socket_path.has_value())
+			server::serve(socket_path.value());
+		// client mode
+		else if (const auto socket_path{ args.typegetv<opt::Option>("connect") }; socket_path.has_value())
+			return server::connect(socket_path.value(), has_stdin, parameters);
+
+		// binary mode
+		if (const auto binary_type{ args.typegetv<opt::Option>("binary") }; binary_type.has_value()) {
+			const auto type{ parse_number_type(binary_type.value()) };
+			if (!type.has_value() || binary::element_size(type.value()) == 0ull)
+				throw argument_exception("binary", "f32|f64", binary_type.value(), " is not a valid binary value type!");
+			if (parameters.size() != 2ull)
+				throw argument_exception("binary", "Expected exactly 2 parameters, the input & output units; got ", parameters.size(), '!');
+			const bool in_place{ args.check<opt::Option>("in-place") };
+			if (!has_stdin && input_files.empty())
+				throw make_exception("Nothing to do.");
+			binary::convert(type.value(), getUnit(parameters[0]), getUnit(parameters[1]), has_stdin && !in_place, input_files, args.typegetv<opt::Option>("output").value_or(std::string{}), in_place);
 			return 0;
 		}
 
-		// get all parameters
-		if (parameters.empty())
-			throw make_exception("Nothing to do.");
+		// column mode
+		if (const auto csv{ args.typegetv<opt::Option>("csv") }, tsv{ args.typegetv<opt::Option>("tsv") }; csv.has_value() || tsv.has_value()) {
+			if (parameters.size() != 2ull)
+				throw argument_exception(csv.has_value() ? "csv" : "tsv", "Expected exactly 2 parameters, the input & output units; got ", parameters.size(), '!');
+			const auto in{ getUnit(parameters[0]) }, out{ getUnit(parameters[1]) };
+			const auto columns{ CsvColumns::parse(csv.has_value() ? csv.value() : tsv.value()) };
+			const char delimiter{ csv.has_value() ? ',' : '\t' };
+			if (!has_stdin && input_files.empty())
+				throw make_exception("Nothing to do.");
+
+			// each input is converted separately, so that each can have its own header row
+			visit_number_type(Global.number_type, [&]<typename T>() {
+				if (has_stdin) {
+					CsvConverter<T> converter{ std::cout, delimiter, columns, in, out };
+					WordReader reader{ 0 };
+					while (const auto block{ reader.next_block() })
+						converter.feed(block.value());
+					converter.finish();
+				}
+				for (const auto& path : input_files) {
+					CsvConverter<T> converter{ std::cout, delimiter, columns, in, out };
+					const MappedFile file{ path };
+					converter.feed(file.view());
+					converter.finish();
+				}
+			});
+			return 0;
+		}
+
+		// table mode
+		if (const auto range{ args.typegetv<opt::Option>("range") }; range.has_value()) {
+			if (parameters.size() != 2ull)
+				throw argument_exception("range", "Expected exactly 2 parameters, the input & output units; got ", parameters.size(), '!');
+			auto format{ RangeFormat::ALIGNED };
+			if (const auto name{ args.typegetv<opt::Option>("range-format") }; name.has_value()) {
+				const auto parsed{ parse_range_format(name.value()) };
+				if (!parsed.has_value())
+					throw argument_exception("range-format", "aligned|csv", name.value(), " is not a valid range format!");
+				format = parsed.value();
+			}
+			const auto in{ getUnit(parameters[0]) }, out{ getUnit(parameters[1]) };
+			visit_number_type(Global.number_type, [&]<typename T>() {
+				RangeWriter<T>{ std::cout, in, parse_range<T>(range.value()), out, format, Global.jobs }.write();
+			});
+			return 0;
+		}
 
-		// lambda to retrieve the current argument & the next 2 arguments as a string tuple. Does NOT check for out-of-range iterators!
-		const auto& getArgTuple{ [&parameters](auto&& it) -> Convert::StrTuple {
-			const auto first{ *it }; // these have to be defined in long form or operator++ causes them to be in the wrong order.
-			const auto second{ *++it };
-			const auto third{ *++it };
-			return{ first, second, third };
+		// lambda that passes each word from STDIN, then each input file, then each parameter to the given function. Returns the number of words.
+		const auto& for_each_word{ [&parameters, &input_files, &has_stdin](auto&& func) -> size_t {
+			size_t count{ 0ull };
+			if (has_stdin) {
+				WordReader reader{ 0 };
+				reader.tie(&std::cout);
+				while (const auto word{ reader.next() }) {
+					func(word.value());
+					++count;
+				}
+			}
+			for (const auto& path : input_files) {
+				const MappedFile file{ path };
+				auto buffer{ file.view() };
+				while (const auto word{ next_word(buffer) }) {
+					func(word.value());
+					++count;
+				}
+			}
+			for (const auto& it : parameters) {
+				stats::count(stats::Counter::BYTES_IN, it.size());
+				func(it);
+				++count;
+			}
+			return count;
 		} };
 
-		for (auto it{ parameters.begin() }; it < parameters.end(); ++it)
-			if (std::distance(it, parameters.end()) > 2ull) // if there are at least 2 more arguments after this one
-				std::cout << Convert(getArgTuple(it), Global.align_to_column) << '\n';
+		// Hidden debug option to dump all parameters to STDOUT
+		if (args.check<opt::Option>("debug-dump-all")) {
+			for_each_word([](auto&& word) { std::cout << Global.palette.get_debug() << '\"' << word << "\"\n"; });
+			return 0;
+		}
+
+		// convert each group of 3 words as soon as it is complete, in the selected number type
+		const auto run_pipeline{ [&for_each_word]<typename PipelineT>() {
+			PipelineT pipeline{ std::cout, Global.jobs };
+			try {
+				for_each_word([&pipeline](auto&& word) { pipeline.push(word); });
+			} catch (...) {
+				// write everything before the failed conversion first, the same as a single-threaded run
+				pipeline.flush();
+				throw;
+			}
+			pipeline.flush();
+			return std::pair{ pipeline.words(), pipeline.skipped() };
+		} };
+		const auto [word_count, skipped] { visit_number_type(Global.number_type, [&run_pipeline]<typename T>() {
+			if (Global.vector)
+				return run_pipeline.template operator()<ConversionPipeline<T, BasicVectorConvert<T>>>();
+			return run_pipeline.template operator()<ConversionPipeline<T>>();
+		}) };
+		if (word_count == 0ull)
+			throw make_exception("Nothing to do.");
+		else if (skipped > 0ull)
+			std::cerr << Global.palette.get_warn() << "Skipped " << skipped << " invalid conversion" << (skipped == 1ull ? "" : "s") << '.' << std::endl;
 
 		rc = 0;
 	} catch (const std::exception& ex) {
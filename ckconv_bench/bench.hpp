@@ -0,0 +1,125 @@
+/**
+ * @file	bench.hpp
+ * @author	radj307
+ * @brief	Minimal microbenchmark harness used by ckconv_bench.
+ */
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+namespace bench {
+	/**
+	 * @brief		Prevent the compiler from optimizing away the computation of a value.
+	 * @param value	Any value.
+	 */
+	template<typename T>
+	inline void do_not_optimize(T const& value)
+	{
+		#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+		#else
+		static volatile char sink;
+		sink = *reinterpret_cast<const volatile char*>(&value);
+		#endif
+	}
+
+	/**
+	 * @struct	Result
+	 * @brief	The timing of a single benchmark.
+	 */
+	struct Result {
+		std::string name;
+		size_t iterations;
+		double seconds;
+		/// @brief	The number of items processed by each iteration.
+		size_t items{ 1ull };
+
+		/// @brief	Nanoseconds per item.
+		double ns_per_op() const { return iterations == 0ull ? 0.0 : (seconds * 1e9) / static_cast<double>(iterations * items); }
+		/// @brief	Items per second.
+		double ops_per_sec() const { return seconds <= 0.0 ? 0.0 : static_cast<double>(iterations * items) / seconds; }
+
+		friend std::ostream& operator<<(std::ostream& os, const Result& r)
+		{
+			return os << std::left << std::setw(40) << r.name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << r.ns_per_op() << " ns/op" << std::setw(14) << r.iterations << " ops";
+		}
+	};
+
+	/// @brief	Every result recorded so far, in the order that they were run.
+	inline std::vector<Result> results;
+	/// @brief	When not empty, only benchmarks whose names contain this string are run.
+	inline std::string filter;
+
+	/// @brief	Returns true when the named benchmark should be run.
+	inline bool enabled(const std::string& name) { return filter.empty() || name.find(filter) != std::string::npos; }
+
+	/**
+	 * @brief				Record a measurement that was taken without run(), such as a single end-to-end pass.
+	 * @param name			The name of this benchmark.
+	 * @param iterations	The number of times the measured operation was performed.
+	 * @param seconds		The total time taken.
+	 * @param items			The number of items processed by each iteration.
+	 * @returns				Result
+	 */
+	inline Result record(const std::string& name, const size_t& iterations, const double& seconds, const size_t& items = 1ull)
+	{
+		Result r{ name, iterations, seconds, items };
+		std::cout << r << std::endl;
+		results.emplace_back(r);
+		return r;
+	}
+
+	/**
+	 * @brief				Run a benchmark function, which receives no arguments & performs one operation per call.
+	 * @param name			The name of this benchmark.
+	 * @param iterations	The number of times to call the function.
+	 * @param fn			The function to benchmark.
+	 * @param items			The number of items processed by each call to fn. Timings are reported per item.
+	 * @returns				Result
+	 */
+	template<typename F>
+	inline Result run(const std::string& name, const size_t& iterations, F&& fn, const size_t& items = 1ull)
+	{
+		if (!enabled(name))
+			return{ name, 0ull, 0.0, items };
+		// warmup
+		for (size_t i{ 0ull }, warmup{ std::max(iterations / 100ull, 1ull) }; i < warmup; ++i)
+			fn();
+		const auto t0{ std::chrono::steady_clock::now() };
+		for (size_t i{ 0ull }; i < iterations; ++i)
+			fn();
+		const auto t1{ std::chrono::steady_clock::now() };
+		return record(name, iterations, std::chrono::duration<double>(t1 - t0).count(), items);
+	}
+
+	/// @brief	Write every recorded result as a JSON array of objects.
+	inline void write_json(std::ostream& os)
+	{
+		os << "[\n";
+		for (size_t i{ 0ull }; i < results.size(); ++i) {
+			const auto& r{ results[i] };
+			os << "  { \"name\": \"";
+			for (const auto& ch : r.name) {
+				if (ch == '\"' || ch == '\\')
+					os << '\\';
+				os << ch;
+			}
+			os << "\", \"iterations\": " << r.iterations << ", \"items\": " << r.items
+				<< std::setprecision(9) << std::defaultfloat
+				<< ", \"seconds\": " << r.seconds << ", \"ns_per_op\": " << r.ns_per_op() << ", \"ops_per_sec\": " << r.ops_per_sec()
+				<< " }" << (i + 1ull < results.size() ? "," : "") << '\n';
+		}
+		os << "]\n";
+	}
+
+	/// @brief	Write every recorded result as CSV, with a header row.
+	inline void write_csv(std::ostream& os)
+	{
+		os << "name,iterations,items,seconds,ns_per_op,ops_per_sec\n" << std::setprecision(9) << std::defaultfloat;
+		for (const auto& r : results)
+			os << r.name << ',' << r.iterations << ',' << r.items << ',' << r.seconds << ',' << r.ns_per_op() << ',' << r.ops_per_sec() << '\n';
+	}
+}
@@ -0,0 +1,90 @@
+/**
+ * @file	generate.hpp
+ * @author	radj307
+ * @brief	Generates reproducible ckconv input for the end-to-end benchmarks.
+ */
+#pragma once
+#include "conv.hpp"
+#include "numeric.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+	/**
+	 * @class	TripleGenerator
+	 * @brief	Produces a deterministic sequence of `<unit> <value> <unit>` triples, using every unit symbol & name that getUnit() accepts.
+	 *\n		Values cover integers, fractions, negative numbers & scientific notation.
+	 */
+	class TripleGenerator {
+		std::uint64_t _state;
+		std::vector<std::string_view> _tokens;
+
+		/// @brief	xorshift64*
+		std::uint64_t next() noexcept
+		{
+			_state ^= _state >> 12u;
+			_state ^= _state << 25u;
+			_state ^= _state >> 27u;
+			return _state * 0x2545F4914F6CDD1Dull;
+		}
+
+		std::string_view unit() noexcept { return _tokens[next() % _tokens.size()]; }
+
+	public:
+		TripleGenerator(const std::uint64_t& seed = 0x9E3779B97F4A7C15ull) : _state{ seed == 0ull ? 1ull : seed }
+		{
+			// symbols & full names take different paths through getUnit(), so use both
+			for (const auto& u : ckconv::UNITS) {
+				for (const auto& token : { u.getSymbol(), u.getName() })
+					if (token.find(' ') == std::string_view::npos && ckconv::UnitIndex.find(token).has_value() && (_tokens.empty() || _tokens.back() != token))
+						_tokens.emplace_back(token);
+			}
+		}
+
+		/// @brief	Append the next triple to a string, followed by a newline.
+		void append(std::string& out)
+		{
+			const auto r{ next() };
+			long double value{ static_cast<long double>(r % 1000000ull) };
+			switch ((r >> 32u) % 4u) {
+			case 1u: value /= 1000.0L; break;
+			case 2u: value = -value / 7.0L; break;
+			case 3u: value *= 1e9L; break;
+			default: break;
+			}
+			out += unit();
+			out += ' ';
+			ckconv::append_number(out, value, 10, ((r >> 32u) % 4u == 3u) ? ckconv::Notation::SCIENTIFIC : ckconv::Notation::AUTO);
+			out += ' ';
+			out += unit();
+			out += '\n';
+		}
+
+		/**
+		 * @brief			Write triples to an output stream.
+		 * @param os		Output stream.
+		 * @param count		The number of triples to write.
+		 * @returns			size_t; the number of bytes written.
+		 */
+		size_t write(std::ostream& os, const size_t& count)
+		{
+			constexpr size_t BLOCK{ 1ull << 16ull };
+			std::string buffer;
+			buffer.reserve(BLOCK + 128ull);
+			size_t bytes{ 0ull };
+			for (size_t i{ 0ull }; i < count; ++i) {
+				append(buffer);
+				if (buffer.size() >= BLOCK) {
+					os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+					bytes += buffer.size();
+					buffer.clear();
+				}
+			}
+			os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			return bytes + buffer.size();
+		}
+	};
+}
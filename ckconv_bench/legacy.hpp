@@ -0,0 +1,183 @@
+/**
+ * @file	legacy.hpp
+ * @author	radj307
+ * @brief	Reference implementations of code paths that have since been replaced, kept for comparison.
+ */
+#pragma once
+#include "conv.hpp"
+
+#include <str.hpp>
+
+#include <cmath>
+#include <vector>
+#include <istream>
+#include <sstream>
+#include <iomanip>
+
+namespace legacy {
+	using namespace ckconv;
+
+	/// @brief	The original sequential getUnit() lookup chain.
+	inline Unit getUnit(const std::string& str, const std::optional<Unit>& def = std::nullopt)
+	{
+		if (str.empty()) {
+			if (def.has_value())
+				return def.value();
+			throw make_exception("No unit specified ; string was empty!");
+		}
+		const auto s{ str::tolower(str) };
+
+		// BEGIN IMPERIAL //
+		if (s.find("twip") < s.size())
+			return *Imperial.TWIP;
+		if (str == "th" || s.find("thou") < s.size())
+			return *Imperial.THOU;
+		if (str == "Bc" || s.find("barleycorn") < s.size())
+			return *Imperial.BARLEYCORN;
+		if (str == "h" || s.find("hand") < s.size())
+			return *Imperial.HAND;
+		if (str == "ch" || s.find("chain") < s.size())
+			return *Imperial.CHAIN;
+		if (str == "fur" || s.find("furlong") < s.size())
+			return *Imperial.FURLONG;
+		if (str == "lea" || s.find("league") < s.size())
+			return *Imperial.LEAGUE;
+		if (str == "ftm" || s.find("fathom") < s.size())
+			return *Imperial.FATHOM;
+		if (s.find("cable") < s.size())
+			return *Imperial.CABLE;
+		if (s.find("link") < s.size())
+			return *Imperial.LINK;
+		if (str == "rd" || s.find("rod") < s.size())
+			return *Imperial.ROD;
+		if (str == "in" || s == "i" || s.find("inch") < s.size())
+			return *Imperial.INCH;
+		if (str == "ft" || s == "f" || s.find("foot") < s.size() || s.find("feet") < s.size())
+			return *Imperial.FOOT;
+		if (str == "yd" || s.find("yard") < s.size())
+			return *Imperial.YARD;
+		if (str == "nmi" || s.find("nauticalmile") < s.size() || s.find("nmile") < s.size())
+			return *Imperial.CABLE;
+		if (str == "mi" || s.find("mile") < s.size())
+			return *Imperial.MILE;
+		// END IMPERIAL //
+
+		// BEGIN METRIC //
+		if (str == "pm" || s.find("picomet") < s.size())
+			return *Metric.PICOMETER;
+		if (str == "nm" || s.find("nanomet") < s.size())
+			return *Metric.NANOMETER;
+		if (str == "um" || s.find("micromet") < s.size())
+			return *Metric.MICROMETER;
+		if (str == "mm" || s.find("millimet") < s.size())
+			return *Metric.MILLIMETER;
+		if (str == "cm" || s.find("centimet") < s.size())
+			return *Metric.CENTIMETER;
+		if (str == "dm" || s.find("decimet") < s.size())
+			return *Metric.DECIMETER;
+		if (str == "dam" || s.find("decamet") < s.size())
+			return *Metric.DECAMETER;
+		if (str == "hm" || s.find("hectomet") < s.size())
+			return *Metric.HECTOMETER;
+		if (str == "km" || s.find("kilomet") < s.size())
+			return *Metric.KILOMETER;
+		if (str == "Mm" || s.find("megamet") < s.size())
+			return *Metric.MEGAMETER;
+		if (str == "Gm" || s.find("gigamet") < s.size())
+			return *Metric.GIGAMETER;
+		if (str == "Tm" || s.find("teramet") < s.size())
+			return *Metric.TERAMETER;
+		if (str == "m" || s.find("met") < s.size())
+			return *Metric.METER;
+		// END METRIC //
+
+		// BEGIN CREATIONKIT //
+		if (str == "pu" || s.find("picounit") < s.size())
+			return *CreationKit.PICOUNIT;
+		if (str == "nu" || s.find("nanounit") < s.size())
+			return *CreationKit.NANOUNIT;
+		if (str == "uu" || s.find("microunit") < s.size())
+			return *CreationKit.MICROUNIT;
+		if (str == "mu" || s.find("milliunit") < s.size())
+			return *CreationKit.MILLIUNIT;
+		if (str == "cu" || s.find("centiunit") < s.size())
+			return *CreationKit.CENTIUNIT;
+		if (str == "du" || s.find("deciunit") < s.size())
+			return *CreationKit.DECIUNIT;
+		if (str == "dau" || s.find("decaunit") < s.size())
+			return *CreationKit.DECAUNIT;
+		if (str == "hu" || s.find("hectounit") < s.size())
+			return *CreationKit.HECTOUNIT;
+		if (str == "ku" || s.find("kilounit") < s.size())
+			return *CreationKit.KILOUNIT;
+		if (str == "Mu" || s.find("megaunit") < s.size())
+			return *CreationKit.MEGAUNIT;
+		if (str == "Gu" || s.find("gigaunit") < s.size())
+			return *CreationKit.GIGAUNIT;
+		if (str == "Tu" || s.find("teraunit") < s.size())
+			return *CreationKit.TERAUNIT;
+		if (str == "u" || s.find("unit") < s.size())
+			return *CreationKit.UNIT;
+		// END CREATIONKIT //
+
+		if (def.has_value())
+			return def.value();
+
+		throw make_exception("Unrecognized Unit: \"", str, '\"');
+	}
+
+	/**
+	 * @struct	DynamicUnit
+	 * @brief	The original heap-backed unit record.
+	 */
+	struct DynamicUnit {
+		UnitId id;
+		SystemID system;
+		long double unitcf;
+		std::string sym, name;
+	};
+
+	/**
+	 * @brief	Build the unit tables the way they were originally built during static initialization,
+	 *\n		 with std::pow for every metric prefix and two heap-allocated strings per unit.
+	 * @returns	std::vector<DynamicUnit>
+	 */
+	inline std::vector<DynamicUnit> build_unit_tables()
+	{
+		constexpr std::array<Powers, 13> PREFIXES{ Powers::PICO, Powers::NANO, Powers::MICRO, Powers::MILLI, Powers::CENTI, Powers::DECI, Powers::BASE, Powers::DECA, Powers::HECTO, Powers::KILO, Powers::MEGA, Powers::GIGA, Powers::TERA };
+		std::vector<DynamicUnit> units;
+		for (const auto& unit : UNITS) {
+			const auto i{ static_cast<size_t>(unit.getId()) };
+			long double cf{ unit.unitcf };
+			if (unit.getSystem() == SystemID::METRIC)
+				cf = std::pow(10.0L, static_cast<long double>(PREFIXES[i]));
+			else if (unit.getSystem() == SystemID::CREATIONKIT)
+				cf = std::pow(10.0L, static_cast<long double>(PREFIXES[i - static_cast<size_t>(UnitId::PICOUNIT)]));
+			units.emplace_back(DynamicUnit{ unit.getId(), unit.getSystem(), cf, std::string{ unit.getSymbol() }, unit.hasName() ? std::string{ unit.getName() } : std::string{} });
+		}
+		return units;
+	}
+
+	/**
+	 * @brief		The original STDIN reader, which read every word into a vector before converting anything.
+	 * @param is	Input stream.
+	 * @returns		std::vector<std::string>
+	 */
+	inline std::vector<std::string> read_words(std::istream& is)
+	{
+		std::vector<std::string> vec;
+		vec.reserve(24);
+		for (std::string word; is >> word; )
+			vec.emplace_back(std::move(word));
+		vec.shrink_to_fit();
+		return vec;
+	}
+
+	/// @brief	The original number formatting, through a stringstream.
+	inline std::string format_number(const long double& value, const int& precision)
+	{
+		std::stringstream ss;
+		ss << std::setprecision(precision) << value;
+		return ss.str();
+	}
+}
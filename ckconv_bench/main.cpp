@@ -0,0 +1,645 @@
+#include "bench.hpp"
+#include "generate.hpp"
+#include "legacy.hpp"
+#include "conv.hpp"
+#include "units.hpp"
+#include "numeric.hpp"
+#include "Pipeline.hpp"
+#include "Range.hpp"
+#include "WordReader.hpp"
+#include "MappedFile.hpp"
+
+#include <ParamsAPI2.hpp>
+
+#include <optional>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include <fcntl.h>
+
+#ifdef OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/// @brief	Every accepted spelling of every unit, plus some strings that aren't units at all.
+static const std::vector<std::string> LOOKUP_TOKENS{
+	"pm", "nm", "um", "mm", "cm", "dm", "m", "dam", "hm", "km", "Mm", "Gm", "Tm",
+	"picometer", "Nanometres", "MICROMETER", "millimetre", "Centimeters", "decimeter", "meter", "Metres", "decameter", "hectometre", "Kilometers", "megameter", "gigametre", "Terameters",
+	"pu", "nu", "uu", "mu", "cu", "du", "u", "dau", "hu", "ku", "Mu", "Gu", "Tu",
+	"picounit", "nanounits", "Microunit", "milliunits", "centiunit", "deciunit", "Unit", "units", "decaunit", "hectounits", "kilounit", "megaunit", "Gigaunits", "teraunit",
+	"twip", "th", "thou", "Bc", "barleycorn", "in", "i", "Inches", "h", "hands", "ft", "f", "foot", "Feet", "yd", "yards", "ch", "chains", "fur", "furlongs", "mi", "miles", "lea", "leagues",
+	"ftm", "fathoms", "cable", "nmi", "NauticalMile", "link", "rd", "rods",
+	"5", "-12.5", "1,000", "", "x", "kilogram", "seconds", "Z",
+};
+
+/// @brief	Output stream buffer that discards everything written to it.
+struct NullBuffer : std::streambuf {
+	int overflow(int c) override { return c; }
+	std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+static const ckconv::Unit& to_unit(const ckconv::Unit& unit) { return unit; }
+static const ckconv::Unit& to_unit(const ckconv::UnitId& id) { return ckconv::getUnit(id); }
+
+/// @brief	Run a lookup function, returning the unit's symbol or std::nullopt if the lookup failed.
+template<typename F>
+static std::optional<std::string> try_lookup(F&& f, const std::string& s)
+{
+	try {
+		return std::string{ to_unit(f(s)).getSymbol() };
+	} catch (...) {
+		return std::nullopt;
+	}
+}
+
+/// @brief	Every unit from every measurement system.
+static std::vector<ckconv::Unit> all_units()
+{
+	std::vector<ckconv::Unit> units;
+	units.insert(units.end(), ckconv::Metric.units.begin(), ckconv::Metric.units.end());
+	units.insert(units.end(), ckconv::Imperial.units.begin(), ckconv::Imperial.units.end());
+	units.insert(units.end(), ckconv::CreationKit.units.begin(), ckconv::CreationKit.units.end());
+	return units;
+}
+
+/// @brief	Verify that the conversion table agrees with convert() for every pair of units, within CONVERSION_TABLE_TOLERANCE.
+static bool verify_conversion_table(const std::vector<ckconv::Unit>& units)
+{
+	constexpr long double values[]{ 1.0L, -12.5L, 0.001L, 123456.789L, 1e-9L, 3e12L };
+	for (const auto& in : units) {
+		for (const auto& out : units) {
+			for (const auto& v : values) {
+				const auto expected{ ckconv::convert(in, v, out) }, actual{ ckconv::convert(in.getId(), v, out.getId()) };
+				if (std::fabs(expected - actual) > std::fabs(expected) * ckconv::CONVERSION_TABLE_TOLERANCE) {
+					std::cerr << "conversion table mismatch for " << v << ' ' << in.getSymbol() << " -> " << out.getSymbol() << ": expected " << expected << ", got " << actual << std::endl;
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/// @brief	Get the IDs of every unit in a system.
+static std::vector<ckconv::UnitId> unit_ids(const ckconv::SystemID& system)
+{
+	std::vector<ckconv::UnitId> ids;
+	for (const auto& unit : ckconv::units_of(system))
+		ids.emplace_back(unit.getId());
+	return ids;
+}
+
+/// @brief	Verify that lists of targets resolve to the right units, both through find_units() & through the pipeline, and that convert_fanout() agrees with convert().
+static bool verify_target_lists()
+{
+	using ckconv::UnitId;
+	const std::pair<std::string_view, std::vector<UnitId>> cases[]{
+		{ "all:metric", unit_ids(ckconv::SystemID::METRIC) },
+		{ "all:units", unit_ids(ckconv::SystemID::CREATIONKIT) },
+		{ "meter,u", { UnitId::METER, UnitId::UNIT } },
+		{ "foot,meter", { UnitId::FOOT, UnitId::METER } },
+		{ "u,ft,cm", { UnitId::UNIT, UnitId::FOOT, UnitId::CENTIMETER } },
+	};
+	for (const auto& [list, expected] : cases) {
+		std::vector<UnitId> targets;
+		if (!ckconv::is_unit_list(list) || !ckconv::find_units(list, targets).has_value() || targets != expected) {
+			std::cerr << "find_units() resolved "" << list << "" to the wrong units" << std::endl;
+			return false;
+		}
+		// the pipeline writes one line per target
+		std::ostringstream ss;
+		{
+			ckconv::ConversionPipeline<> pipeline{ ss, 1ull };
+			for (const auto& word : { std::string_view{ "5" }, std::string_view{ "m" }, std::string_view{ "->" }, list })
+				pipeline.push(word);
+			pipeline.flush();
+		}
+		const auto output{ ss.str() };
+		if (const auto lines{ static_cast<size_t>(std::count(output.begin(), output.end(), '\n')) }; lines != expected.size()) {
+			std::cerr << "the pipeline wrote " << lines << " conversions for \"5 m -> " << list << "\", expected " << expected.size() << std::endl;
+			return false;
+		}
+		// fan-out results must match a separate convert() for each target
+		std::vector<long double> results(targets.size());
+		for (const auto& value : { 1.0L, -12.5L, 3e12L }) {
+			ckconv::convert_fanout<long double>(UnitId::METER, value, targets, results);
+			for (size_t i{ 0ull }; i < targets.size(); ++i) {
+				if (results[i] != ckconv::convert(UnitId::METER, value, targets[i])) {
+					std::cerr << "convert_fanout() mismatch for " << value << " m -> \"" << list << "\" target " << i << ": expected " << ckconv::convert(UnitId::METER, value, targets[i]) << ", got " << results[i] << std::endl;
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/// @brief	Sizes of the generated inputs used by the end-to-end benchmarks, in triples.
+static constexpr const size_t END_TO_END_SIZES[]{ 1000ull, 1000000ull, 100000000ull };
+
+/// @brief	Open a file for reading, returning its file descriptor.
+static int open_read(const std::filesystem::path& path)
+{
+	#ifdef OS_WIN
+	const int fd{ ::_open(path.generic_string().c_str(), _O_RDONLY | _O_BINARY) };
+	#else
+	const int fd{ ::open(path.generic_string().c_str(), O_RDONLY) };
+	#endif
+	if (fd == -1)
+		throw make_exception("Failed to open ", path, ": error ", errno);
+	return fd;
+}
+
+/// @brief	Open an existing file for writing, returning its file descriptor.
+static int open_write(const std::filesystem::path& path)
+{
+	#ifdef OS_WIN
+	const int fd{ ::_open(path.generic_string().c_str(), _O_WRONLY | _O_BINARY) };
+	#else
+	const int fd{ ::open(path.generic_string().c_str(), O_WRONLY) };
+	#endif
+	if (fd == -1)
+		throw make_exception("Failed to open ", path, ": error ", errno);
+	return fd;
+}
+
+static void close_fd(const int& fd)
+{
+	#ifdef OS_WIN
+	::_close(fd);
+	#else
+	::close(fd);
+	#endif
+}
+
+/**
+ * @brief			Generate an input file containing the given number of triples.
+ * @param path		The file to create.
+ * @param triples	The number of triples to write.
+ * @returns			size_t; the size of the file in bytes.
+ */
+static size_t generate_input(const std::filesystem::path& path, const size_t& triples)
+{
+	std::ofstream ofs{ path, std::ios::binary | std::ios::trunc };
+	if (!ofs)
+		throw make_exception("Failed to create ", path);
+	return bench::TripleGenerator{}.write(ofs, triples);
+}
+
+static double seconds_since(const std::chrono::steady_clock::time_point& t0)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void write_help(std::ostream& os)
+{
+	os
+		<< "ckconv_bench  Benchmarks every stage of the ckconv pipeline.\n"
+		<< '\n'
+		<< "USAGE:\n"
+		<< "  ckconv_bench [OPTIONS]\n"
+		<< '\n'
+		<< "OPTIONS:\n"
+		<< "  -h  --help               Show this help display.\n"
+		<< "  -n  --iterations <#>     The number of iterations of each microbenchmark. (Default: 1000000)\n"
+		<< "  -j  --jobs <#>           The number of jobs used by the end-to-end benchmarks. (Default: 1)\n"
+		<< "      --max-triples <#>    Only run end-to-end benchmarks with at most this many triples. (Default: 1000000)\n"
+		<< "                           Use 100000000 to include the largest input, which needs several GB of temporary disk space.\n"
+		<< "      --filter <name>      Only run benchmarks whose names contain the given string.\n"
+		<< "      --verify             Only check the conversion table, unit index & lists of target units, then exit.\n"
+		<< "                           This is the conversion_table test; the exit code is 1 when any check fails.\n"
+		<< "      --ckconv <path>      Path to a ckconv executable, used to measure process startup latency.\n"
+		<< "      --baseline <path>    Path to another ckconv executable, such as an older build, whose startup latency is measured for comparison.\n"
+		<< "      --json <path>        Write results to a JSON file.\n"
+		<< "      --csv <path>         Write results to a CSV file.\n"
+		;
+}
+
+/**
+ * @brief	Print the accuracy of conversions in float & double, relative to the long double reference implementation.
+ *\n		Every pair of units is converted with values spanning 1e-6 to 1e9, including the rounding of the input value to T.
+ */
+static void report_accuracy(const std::vector<ckconv::Unit>& units)
+{
+	std::cout << std::left << std::setw(40) << "accuracy" << std::right << std::setw(18) << "max rel. error" << std::setw(18) << "mean rel. error" << '\n';
+	for (const auto& type : { ckconv::NumberType::LONG_DOUBLE, ckconv::NumberType::DOUBLE, ckconv::NumberType::FLOAT }) {
+		ckconv::visit_number_type(type, [&]<typename T>() {
+			long double max_error{ 0.0L }, sum_error{ 0.0L };
+			size_t count{ 0ull };
+			for (const auto& in : units) {
+				for (const auto& out : units) {
+					for (long double v{ 1e-6L }; v < 1e9L; v *= 3.7L) {
+						const auto expected{ ckconv::convert(in, v, out) };
+						const auto actual{ static_cast<long double>(ckconv::convert(in.getId(), static_cast<T>(v), out.getId())) };
+						const auto error{ std::fabs(actual - expected) / std::fabs(expected) };
+						max_error = std::max(max_error, error);
+						sum_error += error;
+						++count;
+					}
+				}
+			}
+			std::cout << std::left << std::setw(40) << ("accuracy/" + ckconv::number_type_name(type)) << std::right << std::scientific << std::setprecision(3)
+				<< std::setw(18) << max_error << std::setw(18) << (sum_error / static_cast<long double>(count)) << std::defaultfloat << '\n';
+		});
+	}
+	std::cout << std::flush;
+}
+
+int main(const int argc, char** argv)
+{
+	try {
+		opt::ParamsAPI2 args{ argc, argv, 'n', "iterations", 'j', "jobs", "max-triples", "filter", "ckconv", "baseline", "json", "csv" };
+		if (args.check_any<opt::Flag, opt::Option>('h', "help")) {
+			write_help(std::cout);
+			return 0;
+		}
+		const size_t iterations{ std::stoull(args.typegetv_any<opt::Flag, opt::Option>('n', "iterations").value_or("1000000")) };
+		const size_t jobs{ std::max<size_t>(std::stoull(args.typegetv_any<opt::Flag, opt::Option>('j', "jobs").value_or("1")), 1ull) };
+		const size_t max_triples{ std::stoull(args.typegetv<opt::Option>("max-triples").value_or("1000000")) };
+		bench::filter = args.typegetv<opt::Option>("filter").value_or("");
+		// optional paths to ckconv executables, used to measure & compare process startup latency
+		const auto executable{ args.typegetv<opt::Option>("ckconv") }, baseline{ args.typegetv<opt::Option>("baseline") };
+		const auto json_path{ args.typegetv<opt::Option>("json") }, csv_path{ args.typegetv<opt::Option>("csv") };
+
+		const auto units{ all_units() };
+
+		if (!verify_conversion_table(units))
+			return 1;
+
+		// verify that the index resolves every token to the same unit as the original chain
+		for (const auto& token : LOOKUP_TOKENS) {
+			const auto expected{ try_lookup([](auto&& s) { return legacy::getUnit(s); }, token) }, actual{ try_lookup([](auto&& s) { return ckconv::getUnit(s); }, token) };
+			if (expected != actual) {
+				std::cerr << "getUnit() mismatch for \"" << token << "\": expected " << expected.value_or("<error>") << ", got " << actual.value_or("<error>") << std::endl;
+				return 1;
+			}
+		}
+		if (!verify_target_lists())
+			return 1;
+		if (args.check<opt::Option>("verify")) {
+			std::cout << "conversion table, unit index & target lists verified (" << units.size() << " units)" << std::endl;
+			return 0;
+		}
+
+		if (bench::enabled("accuracy"))
+			report_accuracy(units);
+
+		// only benchmark tokens that resolve, so that exception handling doesn't dominate the measurement
+		std::vector<std::string> tokens;
+		for (const auto& token : LOOKUP_TOKENS)
+			if (ckconv::UnitIndex.find(token).has_value())
+				tokens.emplace_back(token);
+
+		// [getUnit] unit lookup
+		size_t i{ 0ull };
+		bench::run("getUnit/legacy-chain", iterations, [&]() { bench::do_not_optimize(legacy::getUnit(tokens[i++ % tokens.size()]).unitcf); });
+		i = 0ull;
+		bench::run("getUnit/index", iterations, [&]() { bench::do_not_optimize(ckconv::getUnit(tokens[i++ % tokens.size()])); });
+		i = 0ull;
+		bench::run("UnitLookup::find", iterations, [&]() { bench::do_not_optimize(ckconv::UnitIndex.find(tokens[i++ % tokens.size()])); });
+
+		// [parse] number parsing
+		std::vector<std::string> numbers;
+		{
+			std::string line;
+			bench::TripleGenerator gen;
+			for (size_t j{ 0ull }; j < 4096ull; ++j) {
+				line.clear();
+				gen.append(line);
+				std::string_view buffer{ line };
+				ckconv::next_word(buffer);
+				numbers.emplace_back(ckconv::next_word(buffer).value());
+			}
+		}
+		i = 0ull;
+		bench::run("parse/str::stold", iterations, [&]() { bench::do_not_optimize(str::stold(numbers[i++ % numbers.size()])); });
+		i = 0ull;
+		bench::run("parse/parse_number", iterations, [&]() {
+			long double v;
+			bench::do_not_optimize(ckconv::parse_number(numbers[i++ % numbers.size()], v));
+			bench::do_not_optimize(v);
+		});
+		// invalid conversions, reported by exception & by ckconv::expected
+		bench::run("parse/invalid/throw", iterations, [&]() {
+			try {
+				bench::do_not_optimize(ckconv::Convert("m", "1x", "ft"));
+			} catch (const std::exception& ex) {
+				bench::do_not_optimize(ex.what());
+			}
+		});
+		bench::run("parse/invalid/expected", iterations, [&]() { bench::do_not_optimize(ckconv::Convert::try_make("m", "1x", "ft").has_value()); });
+		// [startup] static initialization cost of the legacy unit tables; the current tables are constant-initialized, so they have no runtime counterpart
+		const size_t startup_iterations{ std::max<size_t>(iterations / 100ull, 1ull) };
+		bench::run("startup/legacy-tables", startup_iterations, [&]() { bench::do_not_optimize(legacy::build_unit_tables().size()); });
+		// process startup latency of each executable; both include the overhead of the shell used by std::system, so only the difference between them is meaningful
+		for (const auto& [name, path] : { std::pair{ "startup/process/baseline", baseline }, std::pair{ "startup/process/current", executable } }) {
+			if (!path.has_value())
+				continue;
+			const auto command{ "\"" + path.value() + "\" --version" +
+			#ifdef OS_WIN
+				" > NUL"
+			#else
+				" > /dev/null"
+			#endif
+			};
+			bench::run(name, std::max<size_t>(iterations / 10000ull, 10ull), [&]() { bench::do_not_optimize(std::system(command.c_str())); });
+		}
+
+		// [convert] conversions between every pair of units
+		i = 0ull;
+		long double value{ 1.5L };
+		bench::run("convert/reference", iterations, [&]() {
+			const auto& in{ units[i % units.size()] }, & out{ units[(i++ / units.size()) % units.size()] };
+			bench::do_not_optimize(ckconv::convert(in, value, out));
+		});
+		i = 0ull;
+		bench::run("convert/table", iterations, [&]() {
+			const auto& in{ units[i % units.size()] }, & out{ units[(i++ / units.size()) % units.size()] };
+			bench::do_not_optimize(ckconv::convert(in.getId(), value, out.getId()));
+		});
+		{ // compile-time units, for comparison with the table lookup
+			double v{ static_cast<double>(value) };
+			bench::run("convert/typed", iterations, [&]() {
+				v = ckconv::convert<ckconv::units::Meter, ckconv::units::Unit>(v);
+				bench::do_not_optimize(v);
+				v = ckconv::convert<ckconv::units::Unit, ckconv::units::Meter>(v);
+			});
+		}
+		for (const auto& type : { ckconv::NumberType::DOUBLE, ckconv::NumberType::FLOAT }) {
+			ckconv::visit_number_type(type, [&]<typename T>() {
+				i = 0ull;
+				const auto v{ static_cast<T>(value) };
+				bench::run("convert/table/" + ckconv::number_type_name(type), iterations, [&]() {
+					const auto& in{ units[i % units.size()] }, & out{ units[(i++ / units.size()) % units.size()] };
+					bench::do_not_optimize(ckconv::convert(in.getId(), v, out.getId()));
+				});
+			});
+		}
+
+		{ // one value to every unit; one lookup per target, versus one row of the table for all of them
+			std::vector<ckconv::UnitId> targets;
+			ckconv::find_units("all", targets);
+			std::vector<long double> results(targets.size());
+			i = 0ull;
+			bench::run("convert/fanout/per-target", iterations / targets.size(), [&]() {
+				const auto& in{ targets[i++ % targets.size()] };
+				for (size_t j{ 0ull }; j < targets.size(); ++j)
+					results[j] = ckconv::convert(in, value, targets[j]);
+				bench::do_not_optimize(results.data());
+			}, targets.size());
+			i = 0ull;
+			bench::run("convert/fanout/convert_fanout", iterations / targets.size(), [&]() {
+				ckconv::convert_fanout<long double>(targets[i++ % targets.size()], value, targets, results);
+				bench::do_not_optimize(results.data());
+			}, targets.size());
+		}
+
+		// batch conversions
+		constexpr size_t BATCH_SIZE{ 1ull << 16ull };
+		const size_t batch_iterations{ std::max<size_t>(iterations / BATCH_SIZE, 1ull) };
+		std::vector<long double> values_ld(BATCH_SIZE);
+		std::vector<double> values_d(BATCH_SIZE), out_d(BATCH_SIZE);
+		std::vector<float> values_f(BATCH_SIZE), out_f(BATCH_SIZE);
+		for (size_t j{ 0ull }; j < BATCH_SIZE; ++j)
+			values_f[j] = static_cast<float>(values_d[j] = static_cast<double>(values_ld[j] = static_cast<long double>(j) * 0.25L - 1000.0L));
+		const auto& meter{ *ckconv::Metric.METER }, & unit{ *ckconv::CreationKit.UNIT };
+
+		bench::run("convert/loop-reference", batch_iterations, [&]() {
+			for (const auto& v : values_ld)
+				bench::do_not_optimize(ckconv::convert(meter, v, unit));
+		}, BATCH_SIZE);
+		for (const auto& isa : { ckconv::simd::InstructionSet::SCALAR, ckconv::simd::InstructionSet::SSE2, ckconv::simd::InstructionSet::AVX2 }) {
+			if (isa > ckconv::simd::active())
+				continue;
+			bench::run("convert_batch/double/"s + ckconv::simd::name(isa), batch_iterations, [&]() {
+				ckconv::convert_batch<double>(ckconv::UnitId::METER, values_d, ckconv::UnitId::UNIT, out_d, isa);
+				bench::do_not_optimize(out_d.back());
+			}, BATCH_SIZE);
+			bench::run("convert_batch/float/"s + ckconv::simd::name(isa), batch_iterations, [&]() {
+				ckconv::convert_batch<float>(ckconv::UnitId::METER, values_f, ckconv::UnitId::UNIT, out_f, isa);
+				bench::do_not_optimize(out_f.back());
+			}, BATCH_SIZE);
+		}
+		// x,y,z vectors, interleaved & as a structure of arrays
+		constexpr size_t VECTOR_BATCH_SIZE{ BATCH_SIZE / 3ull };
+		std::vector<ckconv::Vector3<float>> vectors_f(VECTOR_BATCH_SIZE), vectors_out_f(VECTOR_BATCH_SIZE);
+		ckconv::VectorBatch<float> vector_batch_f;
+		vector_batch_f.reserve(VECTOR_BATCH_SIZE);
+		for (size_t j{ 0ull }; j < VECTOR_BATCH_SIZE; ++j)
+			vector_batch_f.push_back(vectors_f[j] = { values_f[j * 3ull], values_f[j * 3ull + 1ull], values_f[j * 3ull + 2ull] });
+		bench::run("convert_batch/vec3/float/interleaved", batch_iterations, [&]() {
+			ckconv::convert_batch<float>(ckconv::UnitId::METER, vectors_f, ckconv::UnitId::UNIT, vectors_out_f);
+			bench::do_not_optimize(vectors_out_f.back().z);
+		}, VECTOR_BATCH_SIZE);
+		bench::run("convert_batch/vec3/float/soa", batch_iterations, [&]() {
+			// alternate directions so that the values stay in range
+			ckconv::convert_batch<float>(ckconv::UnitId::METER, vector_batch_f, ckconv::UnitId::UNIT);
+			ckconv::convert_batch<float>(ckconv::UnitId::UNIT, vector_batch_f, ckconv::UnitId::METER);
+			bench::do_not_optimize(vector_batch_f.z.back());
+		}, VECTOR_BATCH_SIZE * 2ull);
+
+		// [format] formatting a single conversion or number
+		NullBuffer null_buffer;
+		std::ostream null_stream{ &null_buffer };
+		i = 0ull;
+		bench::run("format/stringstream", iterations, [&]() { bench::do_not_optimize(legacy::format_number(static_cast<long double>(i++) * 0.37L, ckconv::DEFAULT_PRECISION).size()); });
+		i = 0ull;
+		std::string formatted;
+		bench::run("format/append_number", iterations, [&]() {
+			formatted.clear();
+			ckconv::append_number(formatted, static_cast<long double>(i++) * 0.37L, ckconv::DEFAULT_PRECISION);
+			bench::do_not_optimize(formatted.size());
+		});
+		// formatting throughput by number of jobs
+		constexpr size_t SCALING_TRIPLES{ 1ull << 18ull };
+		std::vector<ckconv::Convert> conversions;
+		conversions.reserve(SCALING_TRIPLES);
+		for (size_t j{ 0ull }; j < SCALING_TRIPLES; ++j)
+			conversions.emplace_back(tokens[j % tokens.size()], std::to_string(static_cast<double>(j) * 0.37), tokens[(j / tokens.size()) % tokens.size()], ckconv::Global.align_to_column);
+		const size_t max_jobs{ std::max(std::thread::hardware_concurrency(), 1u) };
+		for (size_t n{ 1ull }; n <= max_jobs; n = (n * 2ull > max_jobs && n != max_jobs) ? max_jobs : n * 2ull) {
+			bench::run("ConversionWriter/jobs=" + std::to_string(n), 1ull, [&]() {
+				ckconv::ConversionWriter writer{ null_stream, n };
+				for (const auto& conv : conversions)
+					writer.push(ckconv::Convert{ conv });
+				writer.flush();
+			}, SCALING_TRIPLES);
+		}
+		i = 0ull;
+		bench::run("format/Convert", iterations, [&]() { null_stream << conversions[i++ % conversions.size()] << '\n'; });
+
+		// [output] writing formatted conversions to the null device, through a file stream & through OutputSink
+		{
+			#ifdef OS_WIN
+			const std::filesystem::path null_device{ "NUL" };
+			#else
+			const std::filesystem::path null_device{ "/dev/null" };
+			#endif
+			bench::run("output/ofstream", 1ull, [&]() {
+				std::ofstream ofs{ null_device, std::ios_base::binary };
+				for (const auto& conv : conversions)
+					ofs << conv << '\n';
+				ofs.flush();
+			}, SCALING_TRIPLES);
+			for (const auto& [name, mode] : { std::pair{ "line", ckconv::FlushMode::LINE }, std::pair{ "block", ckconv::FlushMode::BLOCK } }) {
+				bench::run(std::string{ "output/OutputSink/" } + name, 1ull, [&]() {
+					const int fd{ open_write(null_device) };
+					{
+						std::ostream os{ nullptr };
+						ckconv::OutputSink sink{ os, fd, mode };
+						for (const auto& conv : conversions)
+							os << conv << '\n';
+						os.flush();
+					}
+					close_fd(fd);
+				}, SCALING_TRIPLES);
+			}
+		}
+
+		// [range] generating a conversion table, with no input to parse
+		{
+			constexpr size_t RANGE_ROWS{ 1ull << 20ull };
+			constexpr ckconv::NumberType NUMBER_TYPES[]{ ckconv::NumberType::LONG_DOUBLE, ckconv::NumberType::DOUBLE, ckconv::NumberType::FLOAT };
+			for (const auto& type : NUMBER_TYPES) {
+				for (const auto& n : { size_t{ 1ull }, max_jobs }) {
+					ckconv::visit_number_type(type, [&]<typename T>() {
+						const ckconv::Range<T> range{ static_cast<T>(0), static_cast<T>(RANGE_ROWS - 1ull) / static_cast<T>(2), static_cast<T>(0.5) };
+						bench::run("range/" + ckconv::number_type_name(type) + "/jobs=" + std::to_string(n), 1ull, [&]() {
+							bench::do_not_optimize(ckconv::RangeWriter<T>{ null_stream, ckconv::UnitId::METER, range, ckconv::UnitId::UNIT, ckconv::RangeFormat::ALIGNED, n }.write());
+						}, RANGE_ROWS);
+					});
+					if (max_jobs == 1ull)
+						break;
+				}
+			}
+		}
+
+		// [reader] splitting input into words
+		const auto temp_dir{ std::filesystem::temp_directory_path() };
+		{
+			constexpr size_t READER_TRIPLES{ 1ull << 16ull };
+			const auto path{ temp_dir / "ckconv_bench_reader.txt" };
+			const auto bytes{ generate_input(path, READER_TRIPLES) };
+			const size_t reader_iterations{ std::max<size_t>(iterations / (READER_TRIPLES * 3ull), 1ull) };
+			bench::run("reader/istream", reader_iterations, [&]() {
+				std::ifstream ifs{ path, std::ios::binary };
+				bench::do_not_optimize(legacy::read_words(ifs).size());
+			}, READER_TRIPLES * 3ull);
+			bench::run("reader/WordReader", reader_iterations, [&]() {
+				const int fd{ open_read(path) };
+				ckconv::WordReader reader{ fd };
+				size_t count{ 0ull };
+				while (const auto word{ reader.next() })
+					count += word->size();
+				close_fd(fd);
+				bench::do_not_optimize(count);
+			}, READER_TRIPLES * 3ull);
+			bench::run("reader/MappedFile", reader_iterations, [&]() {
+				const ckconv::MappedFile file{ path };
+				auto buffer{ file.view() };
+				size_t count{ 0ull };
+				while (const auto word{ ckconv::next_word(buffer) })
+					count += word->size();
+				bench::do_not_optimize(count);
+			}, READER_TRIPLES * 3ull);
+			bench::do_not_optimize(bytes);
+			std::filesystem::remove(path);
+		}
+
+		// [binary] scaling a mapped f64 file, with pages faulted in on first access or all at once when it is mapped
+		if (bench::enabled("binary/mapped/lazy") || bench::enabled("binary/mapped/populate")) {
+			constexpr size_t BINARY_VALUES{ 1ull << 22ull };
+			const auto path{ temp_dir / "ckconv_bench_binary.bin" };
+			{
+				std::vector<double> values(BINARY_VALUES);
+				for (size_t j{ 0ull }; j < values.size(); ++j)
+					values[j] = static_cast<double>(j) * 0.25;
+				std::ofstream ofs{ path, std::ios::binary | std::ios::trunc };
+				ofs.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(double)));
+			}
+			std::vector<double> scratch(1ull << 16ull);
+			for (const auto& [name, populate] : { std::pair{ "binary/mapped/lazy", false }, std::pair{ "binary/mapped/populate", true } }) {
+				bench::run(name, 10ull, [&]() {
+					const ckconv::MappedFile file{ path, ckconv::MappedFile::Mode::READ, 0ull, populate };
+					const auto* const values{ reinterpret_cast<const double*>(file.data()) };
+					for (size_t j{ 0ull }; j < BINARY_VALUES; j += scratch.size())
+						ckconv::simd::scale(values + j, scratch.data(), std::min(scratch.size(), BINARY_VALUES - j), 1.5);
+					bench::do_not_optimize(scratch.data());
+				}, BINARY_VALUES);
+			}
+			std::filesystem::remove(path);
+		}
+
+		// [e2e] the whole pipeline over generated inputs, one pass each
+		for (const auto& triples : END_TO_END_SIZES) {
+			if (triples > max_triples)
+				continue;
+			const auto suffix{ "/" + std::to_string(triples) + "/jobs=" + std::to_string(jobs) };
+			constexpr ckconv::NumberType NUMBER_TYPES[]{ ckconv::NumberType::LONG_DOUBLE, ckconv::NumberType::DOUBLE, ckconv::NumberType::FLOAT };
+			const auto precision_name{ [&suffix](const ckconv::NumberType& type) { return "e2e/precision-mode=" + ckconv::number_type_name(type) + suffix; } };
+			if (!bench::enabled("e2e/reader" + suffix) && !bench::enabled("e2e/mapped" + suffix)
+				&& std::none_of(std::begin(NUMBER_TYPES), std::end(NUMBER_TYPES), [&](auto&& type) { return bench::enabled(precision_name(type)); }))
+				continue;
+			const auto path{ temp_dir / ("ckconv_bench_e2e_" + std::to_string(triples) + ".txt") };
+			generate_input(path, triples);
+
+			if (bench::enabled("e2e/reader" + suffix)) {
+				const auto t0{ std::chrono::steady_clock::now() };
+				const int fd{ open_read(path) };
+				ckconv::WordReader reader{ fd };
+				ckconv::ConversionPipeline pipeline{ null_stream, jobs };
+				while (const auto word{ reader.next() })
+					pipeline.push(word.value());
+				pipeline.flush();
+				close_fd(fd);
+				bench::record("e2e/reader" + suffix, 1ull, seconds_since(t0), pipeline.triples());
+			}
+			if (bench::enabled("e2e/mapped" + suffix)) {
+				const auto t0{ std::chrono::steady_clock::now() };
+				const ckconv::MappedFile file{ path };
+				auto buffer{ file.view() };
+				ckconv::ConversionPipeline pipeline{ null_stream, jobs };
+				while (const auto word{ ckconv::next_word(buffer) })
+					pipeline.push(word.value());
+				pipeline.flush();
+				bench::record("e2e/mapped" + suffix, 1ull, seconds_since(t0), pipeline.triples());
+			}
+			// throughput of each --precision-mode
+			for (const auto& type : NUMBER_TYPES) {
+				if (!bench::enabled(precision_name(type)))
+					continue;
+				ckconv::visit_number_type(type, [&]<typename T>() {
+					const auto t0{ std::chrono::steady_clock::now() };
+					const ckconv::MappedFile file{ path };
+					auto buffer{ file.view() };
+					ckconv::ConversionPipeline<T> pipeline{ null_stream, jobs };
+					while (const auto word{ ckconv::next_word(buffer) })
+						pipeline.push(word.value());
+					pipeline.flush();
+					bench::record(precision_name(type), 1ull, seconds_since(t0), pipeline.triples());
+				});
+			}
+			std::filesystem::remove(path);
+		}
+
+		// machine-readable results
+		if (json_path.has_value()) {
+			std::ofstream ofs{ json_path.value() };
+			bench::write_json(ofs);
+		}
+		if (csv_path.has_value()) {
+			std::ofstream ofs{ csv_path.value() };
+			bench::write_csv(ofs);
+		}
+		return 0;
+	} catch (const std::exception& ex) {
+		std::cerr << ex.what() << std::endl;
+	}
+	return 1;
+}
@@ -0,0 +1,168 @@
+#include "ckconv.h"
+#include "conv.hpp"
+#include "numeric.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	inline bool valid(const ckconv_unit& unit) noexcept { return unit < ckconv::UNIT_COUNT; }
+	inline ckconv::UnitId id(const ckconv_unit& unit) noexcept { return static_cast<ckconv::UnitId>(unit); }
+
+	inline ckconv_status to_status(const std::errc& ec) noexcept
+	{
+		if (ec == std::errc{})
+			return CKCONV_OK;
+		switch (ec) {
+		case std::errc::result_out_of_range:
+			return CKCONV_OUT_OF_RANGE;
+		default:
+			return CKCONV_INVALID_NUMBER;
+		}
+	}
+
+	template<typename T>
+	inline ckconv_status convert_batch(const ckconv_unit& in, const T* input, T* output, const size_t& count, const ckconv_unit& out) noexcept
+	{
+		if (!valid(in) || !valid(out) || (count > 0ull && (input == nullptr || output == nullptr)))
+			return CKCONV_INVALID_ARGUMENT;
+		ckconv::simd::scale(input, output, count, static_cast<T>(ckconv::conversion_factor(id(in), id(out))));
+		return CKCONV_OK;
+	}
+
+	template<typename T>
+	inline ckconv_status convert_range(const ckconv_unit& in, const T& start, const T& step, const size_t& count, const ckconv_unit& out, T* output) noexcept
+	{
+		if (!valid(in) || !valid(out) || (count > 0ull && output == nullptr))
+			return CKCONV_INVALID_ARGUMENT;
+		// only the start & step are used to compute values by index
+		const ckconv::Range<T> range{ start, start, step };
+		const std::span<T> values{ output, count };
+		ckconv::convert_range(id(in), range, 0ull, id(out), values, values);
+		return CKCONV_OK;
+	}
+
+	template<typename T>
+	inline ckconv_status convert_fanout(const ckconv_unit& in, const T& value, const ckconv_unit* out, const size_t& count, T* output) noexcept
+	{
+		if (!valid(in) || (count > 0ull && (out == nullptr || output == nullptr)) || !std::all_of(out, out + count, valid))
+			return CKCONV_INVALID_ARGUMENT;
+		// the same as ckconv::convert_fanout(), without copying the units into an array of ckconv::UnitId
+		for (size_t i{ 0ull }; i < count; ++i)
+			output[i] = value * ckconv::conversion_factor<T>(id(in), id(out[i]));
+		return CKCONV_OK;
+	}
+}
+
+extern "C" {
+	size_t ckconv_unit_count(void)
+	{
+		return ckconv::UNIT_COUNT;
+	}
+
+	ckconv_status ckconv_find_unit(const char* str, size_t len, ckconv_unit* unit)
+	{
+		if ((str == nullptr && len > 0ull) || unit == nullptr)
+			return CKCONV_INVALID_ARGUMENT;
+		if (const auto id{ ckconv::UnitIndex.find({ str, len }) }; id.has_value()) {
+			*unit = static_cast<ckconv_unit>(id.value());
+			return CKCONV_OK;
+		}
+		return CKCONV_UNKNOWN_UNIT;
+	}
+
+	const char* ckconv_unit_symbol(ckconv_unit unit)
+	{
+		return valid(unit) ? ckconv::getUnit(id(unit)).getSymbol().data() : nullptr;
+	}
+
+	const char* ckconv_unit_name(ckconv_unit unit)
+	{
+		return valid(unit) ? ckconv::getUnit(id(unit)).getName().data() : nullptr;
+	}
+
+	ckconv_status ckconv_factor(ckconv_unit in, ckconv_unit out, double* factor)
+	{
+		if (!valid(in) || !valid(out) || factor == nullptr)
+			return CKCONV_INVALID_ARGUMENT;
+		*factor = static_cast<double>(ckconv::conversion_factor(id(in), id(out)));
+		return CKCONV_OK;
+	}
+
+	ckconv_status ckconv_convert(ckconv_unit in, double value, ckconv_unit out, double* result)
+	{
+		if (!valid(in) || !valid(out) || result == nullptr)
+			return CKCONV_INVALID_ARGUMENT;
+		*result = static_cast<double>(ckconv::convert(id(in), static_cast<long double>(value), id(out)));
+		return CKCONV_OK;
+	}
+
+	ckconv_status ckconv_convert_batch_f64(ckconv_unit in, const double* input, double* output, size_t count, ckconv_unit out)
+	{
+		return convert_batch(in, input, output, count, out);
+	}
+
+	ckconv_status ckconv_convert_batch_f32(ckconv_unit in, const float* input, float* output, size_t count, ckconv_unit out)
+	{
+		return convert_batch(in, input, output, count, out);
+	}
+
+	ckconv_status ckconv_convert_vec3_f64(ckconv_unit in, const double* input, double* output, size_t count, ckconv_unit out)
+	{
+		if (count > SIZE_MAX / 3ull)
+			return CKCONV_INVALID_ARGUMENT;
+		return convert_batch(in, input, output, count * 3ull, out);
+	}
+
+	ckconv_status ckconv_convert_vec3_f32(ckconv_unit in, const float* input, float* output, size_t count, ckconv_unit out)
+	{
+		if (count > SIZE_MAX / 3ull)
+			return CKCONV_INVALID_ARGUMENT;
+		return convert_batch(in, input, output, count * 3ull, out);
+	}
+
+	ckconv_status ckconv_convert_range_f64(ckconv_unit in, double start, double step, size_t count, ckconv_unit out, double* output)
+	{
+		return convert_range(in, start, step, count, out, output);
+	}
+
+	ckconv_status ckconv_convert_range_f32(ckconv_unit in, float start, float step, size_t count, ckconv_unit out, float* output)
+	{
+		return convert_range(in, start, step, count, out, output);
+	}
+
+	ckconv_status ckconv_convert_fanout_f64(ckconv_unit in, double value, const ckconv_unit* out, size_t count, double* output)
+	{
+		return convert_fanout(in, value, out, count, output);
+	}
+
+	ckconv_status ckconv_convert_fanout_f32(ckconv_unit in, float value, const ckconv_unit* out, size_t count, float* output)
+	{
+		return convert_fanout(in, value, out, count, output);
+	}
+
+	ckconv_status ckconv_parse_number(const char* str, size_t len, double* value)
+	{
+		if ((str == nullptr && len > 0ull) || value == nullptr)
+			return CKCONV_INVALID_ARGUMENT;
+		return to_status(ckconv::parse_number({ str, len }, *value));
+	}
+
+	ckconv_status ckconv_format_number(double value, int precision, ckconv_notation notation, char* buffer, size_t size, size_t* length)
+	{
+		if ((buffer == nullptr && size > 0ull) || notation < CKCONV_NOTATION_AUTO || notation > CKCONV_NOTATION_SCIENTIFIC)
+			return CKCONV_INVALID_ARGUMENT;
+		try {
+			std::string str;
+			ckconv::append_number(str, value, precision, static_cast<ckconv::Notation>(notation));
+			if (length != nullptr)
+				*length = str.size();
+			if (str.size() >= size)
+				return CKCONV_BUFFER_TOO_SMALL;
+			std::memcpy(buffer, str.c_str(), str.size() + 1ull);
+			return CKCONV_OK;
+		} catch (...) {
+			return CKCONV_OUT_OF_MEMORY;
+		}
+	}
+}
@@ -0,0 +1,149 @@
+/**
+ * @file	ckconv.h
+ * @author	radj307
+ * @brief	Stable C interface to libckconv, for embedding ckconv in other programs without spawning the executable.
+ *\n		None of these functions have any global state, and all of them are thread-safe.
+ */
+#ifndef CKCONV_H
+#define CKCONV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(CKCONV_STATIC)
+#define CKCONV_API
+#elif defined(_WIN32)
+#ifdef CKCONV_EXPORTS
+#define CKCONV_API __declspec(dllexport)
+#else
+#define CKCONV_API __declspec(dllimport)
+#endif
+#else
+#define CKCONV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/// @brief	Identifies a unit. Valid values are 0 to ckconv_unit_count() - 1; see ckconv::UnitId for their order.
+	typedef uint8_t ckconv_unit;
+
+	/// @brief	Result of every fallible function.
+	typedef enum ckconv_status {
+		CKCONV_OK = 0,
+		/// @brief	A pointer was null, or a unit was out of range.
+		CKCONV_INVALID_ARGUMENT = 1,
+		/// @brief	The string isn't a recognized unit symbol or name.
+		CKCONV_UNKNOWN_UNIT = 2,
+		/// @brief	The string isn't a number.
+		CKCONV_INVALID_NUMBER = 3,
+		/// @brief	The number is too large or too small to be represented.
+		CKCONV_OUT_OF_RANGE = 4,
+		/// @brief	The output buffer is too small; the required size is returned.
+		CKCONV_BUFFER_TOO_SMALL = 5,
+		/// @brief	Memory allocation failed.
+		CKCONV_OUT_OF_MEMORY = 6,
+	} ckconv_status;
+
+	/// @brief	Output notation for ckconv_format_number().
+	typedef enum ckconv_notation {
+		CKCONV_NOTATION_AUTO = 0,
+		CKCONV_NOTATION_FIXED = 1,
+		CKCONV_NOTATION_SCIENTIFIC = 2,
+	} ckconv_notation;
+
+	/// @brief	Get the number of units.
+	CKCONV_API size_t ckconv_unit_count(void);
+
+	/**
+	 * @brief			Find the unit referred to by a symbol or name, using the same rules as the ckconv executable.
+	 * @param str		Input string. This doesn't need to be null-terminated.
+	 * @param len		Length of str.
+	 * @param unit		Receives the unit.
+	 */
+	CKCONV_API ckconv_status ckconv_find_unit(const char* str, size_t len, ckconv_unit* unit);
+
+	/// @brief	Get the official symbol of a unit, or null if it is out of range.
+	CKCONV_API const char* ckconv_unit_symbol(ckconv_unit unit);
+	/// @brief	Get the full name of a unit, or null if it is out of range.
+	CKCONV_API const char* ckconv_unit_name(ckconv_unit unit);
+
+	/**
+	 * @brief			Get the factor that converts values in one unit to another.
+	 * @param factor	Receives the factor.
+	 */
+	CKCONV_API ckconv_status ckconv_factor(ckconv_unit in, ckconv_unit out, double* factor);
+
+	/**
+	 * @brief			Convert a single value.
+	 * @param result	Receives the converted value.
+	 */
+	CKCONV_API ckconv_status ckconv_convert(ckconv_unit in, double value, ckconv_unit out, double* result);
+
+	/**
+	 * @brief			Convert an array of values. input & output may be the same array, but must not otherwise overlap.
+	 * @param input		Input array, containing count values.
+	 * @param output	Output array, with room for count values.
+	 */
+	CKCONV_API ckconv_status ckconv_convert_batch_f64(ckconv_unit in, const double* input, double* output, size_t count, ckconv_unit out);
+	/// @copydoc ckconv_convert_batch_f64
+	CKCONV_API ckconv_status ckconv_convert_batch_f32(ckconv_unit in, const float* input, float* output, size_t count, ckconv_unit out);
+
+	/**
+	 * @brief			Convert an array of interleaved x,y,z vectors. input & output may be the same array, but must not otherwise overlap.
+	 * @param input		Input array, containing count vectors (count * 3 values).
+	 * @param output	Output array, with room for count vectors.
+	 * @param count		The number of vectors.
+	 */
+	CKCONV_API ckconv_status ckconv_convert_vec3_f64(ckconv_unit in, const double* input, double* output, size_t count, ckconv_unit out);
+	/// @copydoc ckconv_convert_vec3_f64
+	CKCONV_API ckconv_status ckconv_convert_vec3_f32(ckconv_unit in, const float* input, float* output, size_t count, ckconv_unit out);
+
+	/**
+	 * @brief			Convert the values start, start + step, start + 2 * step, ... from one unit to another, without an input array.
+	 *\n				Each value is computed from its index, so rounding errors don't accumulate.
+	 * @param start		The first input value.
+	 * @param step		The difference between consecutive input values.
+	 * @param count		The number of values.
+	 * @param output	Output array, with room for count values.
+	 */
+	CKCONV_API ckconv_status ckconv_convert_range_f64(ckconv_unit in, double start, double step, size_t count, ckconv_unit out, double* output);
+	/// @copydoc ckconv_convert_range_f64
+	CKCONV_API ckconv_status ckconv_convert_range_f32(ckconv_unit in, float start, float step, size_t count, ckconv_unit out, float* output);
+
+	/**
+	 * @brief			Convert one value to several units at once.
+	 * @param out		Output units, containing count units.
+	 * @param count		The number of output units.
+	 * @param output	Output array, with room for count values; receives the value in each of the output units, in order.
+	 */
+	CKCONV_API ckconv_status ckconv_convert_fanout_f64(ckconv_unit in, double value, const ckconv_unit* out, size_t count, double* output);
+	/// @copydoc ckconv_convert_fanout_f64
+	CKCONV_API ckconv_status ckconv_convert_fanout_f32(ckconv_unit in, float value, const ckconv_unit* out, size_t count, float* output);
+
+	/**
+	 * @brief			Parse a number, using the same rules as the ckconv executable.
+	 * @param str		Input string. This doesn't need to be null-terminated.
+	 * @param len		Length of str.
+	 * @param value		Receives the number.
+	 */
+	CKCONV_API ckconv_status ckconv_parse_number(const char* str, size_t len, double* value);
+
+	/**
+	 * @brief			Format a number, using the same rules as the ckconv executable.
+	 * @param value		The number to format.
+	 * @param precision	The number of digits to show. Negative values use the default (6).
+	 * @param notation	The notation to use. Any other value returns CKCONV_INVALID_ARGUMENT.
+	 * @param buffer	Output buffer. The result is null-terminated.
+	 * @param size		Size of buffer, including room for the null terminator.
+	 * @param length	Receives the length of the result, excluding the null terminator. When the buffer is too small,
+	 *\n				 this receives the required length instead. May be null.
+	 */
+	CKCONV_API ckconv_status ckconv_format_number(double value, int precision, ckconv_notation notation, char* buffer, size_t size, size_t* length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CKCONV_H
@@ -0,0 +1,927 @@
+/**
+ * @file	unit.hpp
+ * @author	radj307
+ * @brief	Contains real-world measurement unit converters, currently supporting metric & imperial.
+ */
+#pragma once
+#include <sysarch.h>
+#include <make_exception.hpp>
+#include <math.hpp>
+#include "simd.hpp"
+#include "expected.hpp"
+
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <span>
+#include <iterator>
+#include <algorithm>
+#include <concepts>
+#include <utility>
+
+namespace ckconv {
+	/**
+	 * @enum	SystemID
+	 * @brief	Accepted Measurement Systems
+	 */
+	enum class SystemID : char {
+		METRIC,
+		IMPERIAL,
+		CREATIONKIT,
+		ALL,
+	};
+
+	/**
+	 * @enum	UnitId
+	 * @brief	Dense index of every unit, ordered by system (Metric, Imperial, CreationKit) and then by position within that system's table.
+	 */
+	enum class UnitId : std::uint8_t {
+		// METRIC
+		PICOMETER, NANOMETER, MICROMETER, MILLIMETER, CENTIMETER, DECIMETER, METER, DECAMETER, HECTOMETER, KILOMETER, MEGAMETER, GIGAMETER, TERAMETER,
+		// IMPERIAL
+		TWIP, THOU, BARLEYCORN, INCH, HAND, FOOT, YARD, CHAIN, FURLONG, MILE, LEAGUE, FATHOM, CABLE, NAUTICAL_MILE, LINK, ROD,
+		// CREATIONKIT
+		PICOUNIT, NANOUNIT, MICROUNIT, MILLIUNIT, CENTIUNIT, DECIUNIT, UNIT, DECAUNIT, HECTOUNIT, KILOUNIT, MEGAUNIT, GIGAUNIT, TERAUNIT,
+	};
+	/// @brief	The total number of units across all measurement systems.
+	inline constexpr const size_t UNIT_COUNT{ static_cast<size_t>(UnitId::TERAUNIT) + 1ull };
+
+	/**
+	 * @class	Unit
+	 * @brief	Describes a single measurement unit. This is a literal type, so every unit table is built at compile time.
+	 */
+	class Unit {
+		UnitId _id;
+		SystemID _system;
+		std::string_view _sym, _name;
+
+	public:
+		long double unitcf; // unit conversion factor
+
+		constexpr Unit(UnitId const& id, SystemID const& system, long double const& unit_conversion_factor, std::string_view const& symbol, std::string_view const& full_name = {}) : _id{ id }, _system{ system }, _sym{ symbol }, _name{ full_name }, unitcf{ unit_conversion_factor } {}
+
+		/// @brief	Retrieve the given value in it's base form.
+		CONSTEXPR long double to_base(const long double& val) const { return val * unitcf; }
+		CONSTEXPR UnitId getId() const noexcept { return _id; }
+		CONSTEXPR SystemID getSystem() const noexcept { return _system; }
+		/// @brief	Get the full name of this unit, or its symbol if it doesn't have one. This is always null-terminated.
+		CONSTEXPR std::string_view getName() const noexcept { return (_name.empty() ? _sym : _name); }
+		/// @brief	Get the symbol of this unit. This is always null-terminated.
+		CONSTEXPR std::string_view getSymbol() const noexcept { return _sym; }
+
+		CONSTEXPR bool hasName() const noexcept { return !_name.empty(); }
+
+		/// @brief	Units are compared by identity, since every unit has exactly one entry in UNITS.
+		CONSTEXPR bool operator==(const Unit& o) const noexcept { return _id == o._id; }
+	};
+
+	enum class Powers : char {
+		PICO = -12,
+		NANO = -9,
+		MICRO = -6,
+		MILLI = -3,
+		CENTI = -2,
+		DECI = -1,
+		BASE = 0,
+		DECA = 1,
+		HECTO = 2,
+		KILO = 3,
+		MEGA = 6,
+		GIGA = 9,
+		TERA = 12,
+	};
+
+	struct System {
+		using T = long double;
+		using U = Unit;
+	};
+
+	/// @brief	Every unit, indexed by UnitId.
+	inline constexpr const std::array<Unit, UNIT_COUNT> UNITS{ {
+		// METRIC (Relative to Meters)
+		{ UnitId::PICOMETER, SystemID::METRIC, 1e-12L, "pm", "Picometer" },
+		{ UnitId::NANOMETER, SystemID::METRIC, 1e-9L, "nm", "Nanometer" },
+		{ UnitId::MICROMETER, SystemID::METRIC, 1e-6L, "um", "Micrometer" },
+		{ UnitId::MILLIMETER, SystemID::METRIC, 1e-3L, "mm", "Millimeter" },
+		{ UnitId::CENTIMETER, SystemID::METRIC, 1e-2L, "cm", "Centimeter" },
+		{ UnitId::DECIMETER, SystemID::METRIC, 1e-1L, "dm", "Decimeter" },
+		{ UnitId::METER, SystemID::METRIC, 1e0L, "m", "Meter" },
+		{ UnitId::DECAMETER, SystemID::METRIC, 1e1L, "dam", "Decameter" },
+		{ UnitId::HECTOMETER, SystemID::METRIC, 1e2L, "hm", "Hectometer" },
+		{ UnitId::KILOMETER, SystemID::METRIC, 1e3L, "km", "Kilometer" },
+		{ UnitId::MEGAMETER, SystemID::METRIC, 1e6L, "Mm", "Megameter" },
+		{ UnitId::GIGAMETER, SystemID::METRIC, 1e9L, "Gm", "Gigameter" },
+		{ UnitId::TERAMETER, SystemID::METRIC, 1e12L, "Tm", "Terameter" },
+		// IMPERIAL (Relative to Feet)
+		{ UnitId::TWIP, SystemID::IMPERIAL, (1.0L / 17280.0L), "Twip" },
+		{ UnitId::THOU, SystemID::IMPERIAL, (1.0L / 12000.0L), "th", "Thou" },
+		{ UnitId::BARLEYCORN, SystemID::IMPERIAL, (1.0L / 36.0L), "Bc", "Barleycorn" },
+		{ UnitId::INCH, SystemID::IMPERIAL, (1.0L / 12.0L), "\"", "Inch" },
+		{ UnitId::HAND, SystemID::IMPERIAL, (1.0L / 3.0L), "h", "Hand" },
+		{ UnitId::FOOT, SystemID::IMPERIAL, (1.0L), "\'", "Feet" },
+		{ UnitId::YARD, SystemID::IMPERIAL, (3.0L), "yd", "Yard" },
+		{ UnitId::CHAIN, SystemID::IMPERIAL, (66.0L), "ch", "Chain" },
+		{ UnitId::FURLONG, SystemID::IMPERIAL, (660.0L), "fur", "Furlong" },
+		{ UnitId::MILE, SystemID::IMPERIAL, (5280.0L), "mi", "Mile" },
+		{ UnitId::LEAGUE, SystemID::IMPERIAL, (15840.0L), "lea", "League" },
+		{ UnitId::FATHOM, SystemID::IMPERIAL, (6.0761L), "ftm", "Fathom" },
+		{ UnitId::CABLE, SystemID::IMPERIAL, (607.61L), "Cable" },
+		{ UnitId::NAUTICAL_MILE, SystemID::IMPERIAL, (6076.1L), "nmi", "Nautical Mile" },
+		{ UnitId::LINK, SystemID::IMPERIAL, (66.0L / 100.0L), "Link" },
+		{ UnitId::ROD, SystemID::IMPERIAL, (66.0L / 4.0L), "rd", "Rod" },
+		// CREATIONKIT (Relative to Units)
+		{ UnitId::PICOUNIT, SystemID::CREATIONKIT, 1e-12L, "pu", "Picounit" },
+		{ UnitId::NANOUNIT, SystemID::CREATIONKIT, 1e-9L, "nu", "Nanounit" },
+		{ UnitId::MICROUNIT, SystemID::CREATIONKIT, 1e-6L, "uu", "Microunit" },
+		{ UnitId::MILLIUNIT, SystemID::CREATIONKIT, 1e-3L, "mu", "Milliunit" },
+		{ UnitId::CENTIUNIT, SystemID::CREATIONKIT, 1e-2L, "cu", "Centiunit" },
+		{ UnitId::DECIUNIT, SystemID::CREATIONKIT, 1e-1L, "du", "Deciunit" },
+		{ UnitId::UNIT, SystemID::CREATIONKIT, 1e0L, "u", "Unit" },
+		{ UnitId::DECAUNIT, SystemID::CREATIONKIT, 1e1L, "dau", "Decaunit" },
+		{ UnitId::HECTOUNIT, SystemID::CREATIONKIT, 1e2L, "hu", "Hectounit" },
+		{ UnitId::KILOUNIT, SystemID::CREATIONKIT, 1e3L, "ku", "Kilometer" },
+		{ UnitId::MEGAUNIT, SystemID::CREATIONKIT, 1e6L, "Mu", "Megaunit" },
+		{ UnitId::GIGAUNIT, SystemID::CREATIONKIT, 1e9L, "Gu", "Gigaunit" },
+		{ UnitId::TERAUNIT, SystemID::CREATIONKIT, 1e12L, "Tu", "Teraunit" },
+	} };
+
+	/**
+	 * @struct	Metric
+	 * @brief	Intra-Metric-System Conversion Factors. (Relative to Meters)
+	 */
+	static constexpr struct : public System { // SystemID::METRIC
+		const std::span<const U> units{ &UNITS[static_cast<size_t>(UnitId::PICOMETER)], &UNITS[static_cast<size_t>(UnitId::TERAMETER)] + 1 };
+
+		const U* PICOMETER{ &UNITS[static_cast<size_t>(UnitId::PICOMETER)] };
+		const U* NANOMETER{ &UNITS[static_cast<size_t>(UnitId::NANOMETER)] };
+		const U* MICROMETER{ &UNITS[static_cast<size_t>(UnitId::MICROMETER)] };
+		const U* MILLIMETER{ &UNITS[static_cast<size_t>(UnitId::MILLIMETER)] };
+		const U* CENTIMETER{ &UNITS[static_cast<size_t>(UnitId::CENTIMETER)] };
+		const U* DECIMETER{ &UNITS[static_cast<size_t>(UnitId::DECIMETER)] };
+		const U* METER{ &UNITS[static_cast<size_t>(UnitId::METER)] };
+		const U* DECAMETER{ &UNITS[static_cast<size_t>(UnitId::DECAMETER)] };
+		const U* HECTOMETER{ &UNITS[static_cast<size_t>(UnitId::HECTOMETER)] };
+		const U* KILOMETER{ &UNITS[static_cast<size_t>(UnitId::KILOMETER)] };
+		const U* MEGAMETER{ &UNITS[static_cast<size_t>(UnitId::MEGAMETER)] };
+		const U* GIGAMETER{ &UNITS[static_cast<size_t>(UnitId::GIGAMETER)] };
+		const U* TERAMETER{ &UNITS[static_cast<size_t>(UnitId::TERAMETER)] };
+
+		// the base unit of the Metric system (meters)
+		const U* const base{ METER };
+	} Metric;
+
+	/**
+	 * @struct	CreationKit
+	 * @brief	Intra-CreationKit-System Conversion Factors. (Relative to Units)
+	 */
+	static constexpr struct : public System { // SystemID::CREATIONKIT
+		const std::span<const U> units{ &UNITS[static_cast<size_t>(UnitId::PICOUNIT)], &UNITS[static_cast<size_t>(UnitId::TERAUNIT)] + 1 };
+
+		const U* PICOUNIT{ &UNITS[static_cast<size_t>(UnitId::PICOUNIT)] };
+		const U* NANOUNIT{ &UNITS[static_cast<size_t>(UnitId::NANOUNIT)] };
+		const U* MICROUNIT{ &UNITS[static_cast<size_t>(UnitId::MICROUNIT)] };
+		const U* MILLIUNIT{ &UNITS[static_cast<size_t>(UnitId::MILLIUNIT)] };
+		const U* CENTIUNIT{ &UNITS[static_cast<size_t>(UnitId::CENTIUNIT)] };
+		const U* DECIUNIT{ &UNITS[static_cast<size_t>(UnitId::DECIUNIT)] };
+		const U* UNIT{ &UNITS[static_cast<size_t>(UnitId::UNIT)] };
+		const U* DECAUNIT{ &UNITS[static_cast<size_t>(UnitId::DECAUNIT)] };
+		const U* HECTOUNIT{ &UNITS[static_cast<size_t>(UnitId::HECTOUNIT)] };
+		const U* KILOUNIT{ &UNITS[static_cast<size_t>(UnitId::KILOUNIT)] };
+		const U* MEGAUNIT{ &UNITS[static_cast<size_t>(UnitId::MEGAUNIT)] };
+		const U* GIGAUNIT{ &UNITS[static_cast<size_t>(UnitId::GIGAUNIT)] };
+		const U* TERAUNIT{ &UNITS[static_cast<size_t>(UnitId::TERAUNIT)] };
+
+		// the base unit of this system
+		const U* const base{ UNIT };
+	} CreationKit;
+
+	/**
+	 * @struct	Imperial
+	 * @brief	Intra-Imperial-System Conversion Factors. (Relative to Feet)
+	 */
+	static constexpr struct : public System { // SystemID::IMPERIAL
+		const std::span<const U> units{ &UNITS[static_cast<size_t>(UnitId::TWIP)], &UNITS[static_cast<size_t>(UnitId::ROD)] + 1 };
+
+		const U* TWIP{ &UNITS[static_cast<size_t>(UnitId::TWIP)] };
+		const U* THOU{ &UNITS[static_cast<size_t>(UnitId::THOU)] };
+		const U* BARLEYCORN{ &UNITS[static_cast<size_t>(UnitId::BARLEYCORN)] };
+		const U* INCH{ &UNITS[static_cast<size_t>(UnitId::INCH)] };
+		const U* HAND{ &UNITS[static_cast<size_t>(UnitId::HAND)] };
+		const U* FOOT{ &UNITS[static_cast<size_t>(UnitId::FOOT)] };
+		const U* YARD{ &UNITS[static_cast<size_t>(UnitId::YARD)] };
+		const U* CHAIN{ &UNITS[static_cast<size_t>(UnitId::CHAIN)] };
+		const U* FURLONG{ &UNITS[static_cast<size_t>(UnitId::FURLONG)] };
+		const U* MILE{ &UNITS[static_cast<size_t>(UnitId::MILE)] };
+		const U* LEAGUE{ &UNITS[static_cast<size_t>(UnitId::LEAGUE)] };
+		const U* FATHOM{ &UNITS[static_cast<size_t>(UnitId::FATHOM)] };
+		const U* CABLE{ &UNITS[static_cast<size_t>(UnitId::CABLE)] };
+		const U* NAUTICAL_MILE{ &UNITS[static_cast<size_t>(UnitId::NAUTICAL_MILE)] };
+		const U* LINK{ &UNITS[static_cast<size_t>(UnitId::LINK)] };
+		const U* ROD{ &UNITS[static_cast<size_t>(UnitId::ROD)] };
+		// the base unit of this system
+		const U* const base{ FOOT };
+	} Imperial;
+
+	/**
+	 * @brief		Retrieve a unit from its UnitId.
+	 * @param id	The unit's UnitId.
+	 * @returns		const Unit&
+	 */
+	inline constexpr const Unit& getUnit(const UnitId& id) noexcept
+	{
+		return UNITS[static_cast<size_t>(id)];
+	}
+
+	/// @brief	Inter-System (Metric:Imperial) Conversion Factor
+	const constexpr auto ONE_FOOT_IN_METERS{ 0.3048L };
+	/// @brief	Inter-System (CKUnit:Metric) Conversion Factor
+	const constexpr auto ONE_UNIT_IN_METERS{ 0.0142875313L }, ONE_UNIT_IN_FEET{ 0.046875L };
+
+	/**
+	 * @brief			Converts between units in one measurement system.
+	 * @param in_unit	Input Conversion Factor
+	 * @param v			Input Value
+	 * @param out_unit	Output Conversion Factor
+	 * @returns			long double
+	 */
+	inline constexpr long double convert_unit(const long double& in_unitcf, const long double& v, const long double& out_unitcf)
+	{
+		if (math::equal(out_unitcf, 0.0L))
+			throw make_exception("convert_unit() failed:  Cannot divide by zero!");
+		return ((v * in_unitcf) / out_unitcf);
+	}
+	/**
+	 * @brief				Convert between measurement systems.
+	 * @param in_system		Input Measurement SystemID
+	 * @param v_base		Input Value, in the input system's base unit. (Metric = Meters, Imperial = Feet)
+	 * @param out_system	Output Measurement SystemID
+	 * @returns				long double
+	 */
+	inline constexpr long double convert_system(const SystemID& in_system, const long double& v_base, const SystemID& out_system)
+	{
+		if (in_system == out_system) // same system
+			return v_base;
+		// convert system
+		switch (in_system) {
+		case SystemID::METRIC:
+			switch (out_system) { // METRIC ->
+			case SystemID::IMPERIAL:
+				return v_base / ONE_FOOT_IN_METERS;
+			case SystemID::CREATIONKIT:
+				return v_base / ONE_UNIT_IN_METERS;
+			default:break;
+			}
+			break;
+		case SystemID::IMPERIAL:
+			switch (out_system) { // IMPERIAL ->
+			case SystemID::METRIC:
+				return v_base * ONE_FOOT_IN_METERS;
+			case SystemID::CREATIONKIT:
+				return v_base / ONE_UNIT_IN_FEET;
+			default:break;
+			}
+			break;
+		case SystemID::CREATIONKIT:
+			switch (out_system) { // CREATIONKIT ->
+			case SystemID::METRIC:
+				return v_base * ONE_UNIT_IN_METERS;
+			case SystemID::IMPERIAL:
+				return v_base * ONE_UNIT_IN_FEET;
+			default:break;
+			}
+			break;
+		default:break;
+		}
+		throw make_exception("convert_system() failed:  No handler exists for the given input type!");
+	}
+
+	/**
+	 * @brief		Convert a number in a given unit to another unit and/or system.
+	 * @param in	Input Unit.
+	 * @param val	Input Value.
+	 * @param out	Output Unit.
+	 * @returns		long double
+	 */
+	inline static constexpr long double convert(const Unit& in, const long double& val, const Unit& out)
+	{
+		if (in.unitcf == 0.0L)
+			throw make_exception("Illegal input conversion factor");
+		if (out.unitcf == 0.0L)
+			throw make_exception("Illegal output conversion factor");
+
+		if (in.getSystem() == out.getSystem()) // convert between units only
+			return convert_unit(in.unitcf, val, out.unitcf);
+		// Convert between systems & units
+		return convert_system(in.getSystem(), in.to_base(static_cast<long double>(val)), out.getSystem()) / out.unitcf;
+	}
+
+	/**
+	 * @brief	Combined input->output conversion factors for every pair of units, indexed by [UnitId in][UnitId out].
+	 *\n		These are generated at compile time using the same arithmetic as convert(), so a conversion is a single multiply.
+	 */
+	inline constexpr const auto CONVERSION_TABLE{ []() {
+		std::array<std::array<long double, UNIT_COUNT>, UNIT_COUNT> table{};
+		for (size_t in{ 0ull }; in < UNIT_COUNT; ++in)
+			for (size_t out{ 0ull }; out < UNIT_COUNT; ++out)
+				table[in][out] = convert_system(UNITS[in].getSystem(), UNITS[in].unitcf, UNITS[out].getSystem()) / UNITS[out].unitcf;
+		return table;
+	}() };
+
+	/**
+	 * @brief	Maximum relative difference between the results of convert() and the conversion table.
+	 *\n		The table applies the input value after combining both factors instead of before, which changes the rounding
+	 *\n		 of intermediate results; this never exceeds a few units in the last place of a long double.
+	 */
+	inline constexpr const long double CONVERSION_TABLE_TOLERANCE{ std::numeric_limits<long double>::epsilon() * 8.0L };
+
+	/**
+	 * @brief	The conversion table, rounded to the given floating-point type.
+	 *\n		Each factor is rounded once from the long double table, so narrower types only lose precision when the value is applied.
+	 */
+	template<std::floating_point T>
+	inline constexpr const auto CONVERSION_TABLE_OF{ []() {
+		std::array<std::array<T, UNIT_COUNT>, UNIT_COUNT> table{};
+		for (size_t in{ 0ull }; in < UNIT_COUNT; ++in)
+			for (size_t out{ 0ull }; out < UNIT_COUNT; ++out)
+				table[in][out] = static_cast<T>(CONVERSION_TABLE[in][out]);
+		return table;
+	}() };
+
+	/**
+	 * @brief		Retrieve the combined conversion factor between two units.
+	 * @tparam T	The floating-point type to retrieve the factor as.
+	 * @param in	Input Unit.
+	 * @param out	Output Unit.
+	 * @returns		T
+	 */
+	template<std::floating_point T = long double>
+	inline constexpr T conversion_factor(const UnitId& in, const UnitId& out) noexcept
+	{
+		if constexpr (std::same_as<T, long double>)
+			return CONVERSION_TABLE[static_cast<size_t>(in)][static_cast<size_t>(out)];
+		else
+			return CONVERSION_TABLE_OF<T>[static_cast<size_t>(in)][static_cast<size_t>(out)];
+	}
+
+	/**
+	 * @brief		Convert a number in a given unit to another unit and/or system, using the precomputed conversion table.
+	 *\n			The arithmetic is performed in T; float & double are much faster than long double, but less precise.
+	 *\n			Use convert(const Unit&, const long double&, const Unit&) for the reference implementation.
+	 * @param in	Input Unit.
+	 * @param val	Input Value.
+	 * @param out	Output Unit.
+	 * @returns		T
+	 */
+	template<std::floating_point T>
+	inline constexpr T convert(const UnitId& in, const T& val, const UnitId& out) noexcept
+	{
+		return val * conversion_factor<T>(in, out);
+	}
+	/// @copydoc convert(const UnitId&, const T&, const UnitId&)
+	inline constexpr long double convert(const UnitId& in, const long double& val, const UnitId& out) noexcept
+	{
+		return convert<long double>(in, val, out);
+	}
+
+	/**
+	 * @brief			Convert an array of values from one unit to another.
+	 *\n				The conversion factor is looked up once, then applied to every element with the best SIMD kernel available.
+	 *\n				input & output may be the same span, but must not otherwise overlap.
+	 * @param in		Input Unit.
+	 * @param input		Input Values.
+	 * @param out		Output Unit.
+	 * @param output	Output Values. This must be at least as large as input.
+	 */
+	template<typename T> requires (std::same_as<T, float> || std::same_as<T, double>)
+	inline void convert_batch(const UnitId& in, std::span<const T> input, const UnitId& out, std::span<T> output, const simd::InstructionSet& isa = simd::active())
+	{
+		if (output.size() < input.size())
+			throw make_exception("convert() failed:  Output span is too small! (", output.size(), " < ", input.size(), ')');
+		simd::scale(input.data(), output.data(), input.size(), conversion_factor<T>(in, out), isa);
+	}
+	/// @copydoc convert_batch
+	inline void convert(const UnitId& in, std::span<const float> input, const UnitId& out, std::span<float> output)
+	{
+		convert_batch<float>(in, input, out, output);
+	}
+	/// @copydoc convert_batch
+	inline void convert(const UnitId& in, std::span<const double> input, const UnitId& out, std::span<double> output)
+	{
+		convert_batch<double>(in, input, out, output);
+	}
+
+	/**
+	 * @struct		Range
+	 * @brief		An arithmetic sequence of values from start to stop (inclusive, when stop is reached exactly), as used by --range.
+	 *\n			Each value is computed from its index rather than by repeated addition, so rounding errors don't accumulate along the range.
+	 * @tparam T	The floating-point type of each value.
+	 */
+	template<std::floating_point T>
+	struct Range {
+		T start, stop, step;
+
+		/// @brief	Returns true when step is finite & non-zero, and moves from start toward stop.
+		bool valid() const noexcept
+		{
+			return std::isfinite(start) && std::isfinite(stop) && std::isfinite(step) && step != static_cast<T>(0) && (stop - start) / step >= static_cast<T>(0);
+		}
+
+		/// @brief	The number of values in the range. This is 0 when the range isn't valid.
+		size_t size() const noexcept
+		{
+			if (!valid())
+				return 0ull;
+			const auto n{ (static_cast<long double>(stop) - static_cast<long double>(start)) / static_cast<long double>(step) };
+			if (n >= static_cast<long double>(std::numeric_limits<size_t>::max() - 1ull))
+				return std::numeric_limits<size_t>::max();
+			auto last{ static_cast<size_t>(std::floor(n)) };
+			// step is usually rounded, so when n is a few units in the last place of T below a whole number & that value rounds to stop,
+			//  it is included; e.g. 0:1:0.1 includes 1
+			if (const auto nearest{ std::round(n) }; nearest > n && nearest - n <= nearest * static_cast<long double>(std::numeric_limits<T>::epsilon()) * 4.0L) {
+				if (const auto next{ (*this)[last + 1ull] }; step > static_cast<T>(0) ? next <= stop : next >= stop)
+					++last;
+			}
+			return last + 1ull;
+		}
+
+		/// @brief	Get the value at the given index. Values that are only different from 0 because of rounding are 0.
+		T operator[](const size_t& i) const noexcept
+		{
+			// computed in long double, and only rounded to T at the end
+			const auto offset{ static_cast<long double>(step) * static_cast<long double>(i) };
+			const auto value{ static_cast<long double>(start) + offset };
+			if (std::abs(value) <= (std::abs(static_cast<long double>(start)) + std::abs(offset)) * static_cast<long double>(std::numeric_limits<T>::epsilon()) * 4.0L)
+				return static_cast<T>(0);
+			return static_cast<T>(value);
+		}
+	};
+
+	/**
+	 * @brief			Fill an array with consecutive values of a range, and convert them from one unit to another.
+	 *\n				The conversion factor is looked up once, then applied to every value with the best SIMD kernel available.
+	 * @param in		Input Unit.
+	 * @param range		The range of input values.
+	 * @param first		The index of the first value in the range.
+	 * @param out		Output Unit.
+	 * @param values	Receives the input values. Its size is the number of values that are converted.
+	 * @param results	Receives the converted values. This must be at least as large as values.
+	 */
+	template<std::floating_point T>
+	inline void convert_range(const UnitId& in, const Range<T>& range, const size_t& first, const UnitId& out, std::span<T> values, std::span<T> results)
+	{
+		if (results.size() < values.size())
+			throw make_exception("convert_range() failed:  Output span is too small! (", results.size(), " < ", values.size(), ')');
+		for (size_t i{ 0ull }; i < values.size(); ++i)
+			values[i] = range[first + i];
+		if constexpr (std::same_as<T, float> || std::same_as<T, double>)
+			simd::scale(values.data(), results.data(), values.size(), conversion_factor<T>(in, out));
+		else {
+			const auto factor{ conversion_factor<T>(in, out) };
+			for (size_t i{ 0ull }; i < values.size(); ++i)
+				results[i] = values[i] * factor;
+		}
+	}
+
+	/**
+	 * @brief			Get every unit in a measurement system, in table order.
+	 * @param system	The measurement system; SystemID::ALL gets every unit.
+	 * @returns			std::span<const Unit>
+	 */
+	inline constexpr std::span<const Unit> units_of(const SystemID& system) noexcept
+	{
+		switch (system) {
+		case SystemID::METRIC:
+			return Metric.units;
+		case SystemID::IMPERIAL:
+			return Imperial.units;
+		case SystemID::CREATIONKIT:
+			return CreationKit.units;
+		default:
+			return UNITS;
+		}
+	}
+
+	/**
+	 * @brief			Convert one value to several units at once.
+	 *\n				The input unit's row of the conversion table already combines the conversion to its system's base unit with the conversion
+	 *\n				 to every other unit, so it is selected once and each target only costs one multiplication.
+	 * @param in		Input Unit.
+	 * @param val		Input Value.
+	 * @param out		Output Units.
+	 * @param results	Receives the converted values, in the same order as out. This must be at least as large as out.
+	 */
+	template<std::floating_point T>
+	inline void convert_fanout(const UnitId& in, const T& val, std::span<const UnitId> out, std::span<T> results)
+	{
+		if (results.size() < out.size())
+			throw make_exception("convert_fanout() failed:  Output span is too small! (", results.size(), " < ", out.size(), ')');
+		const auto& factors{ [&in]() -> const auto& {
+			if constexpr (std::same_as<T, long double>)
+				return CONVERSION_TABLE[static_cast<size_t>(in)];
+			else
+				return CONVERSION_TABLE_OF<T>[static_cast<size_t>(in)];
+		}() };
+		for (size_t i{ 0ull }; i < out.size(); ++i)
+			results[i] = val * factors[static_cast<size_t>(out[i])];
+	}
+
+	/**
+	 * @struct		Vector3
+	 * @brief		A position or extent in three dimensions, where every component is in the same unit.
+	 * @tparam T	The floating-point type of each component.
+	 */
+	template<std::floating_point T>
+	struct Vector3 {
+		T x, y, z;
+
+		constexpr bool operator==(const Vector3&) const noexcept = default;
+	};
+
+	/**
+	 * @brief		Convert a vector from one unit to another.
+	 *\n			Every component is multiplied by the same factor, so this is exactly equivalent to converting each component separately.
+	 * @param in	Input Unit.
+	 * @param vec	Input Vector.
+	 * @param out	Output Unit.
+	 * @returns		Vector3<T>
+	 */
+	template<std::floating_point T>
+	inline constexpr Vector3<T> convert(const UnitId& in, const Vector3<T>& vec, const UnitId& out) noexcept
+	{
+		const auto factor{ conversion_factor<T>(in, out) };
+		return{ vec.x * factor, vec.y * factor, vec.z * factor };
+	}
+
+	/**
+	 * @brief			Convert an array of vectors from one unit to another.
+	 *\n				Since every component is scaled by the same factor, the array is converted as one flat array of 3 * input.size() values,
+	 *\n				 so interleaved x,y,z data doesn't need to be transposed to use the SIMD kernels.
+	 *\n				input & output may be the same span, but must not otherwise overlap.
+	 * @param in		Input Unit.
+	 * @param input		Input Vectors.
+	 * @param out		Output Unit.
+	 * @param output	Output Vectors. This must be at least as large as input.
+	 */
+	template<typename T> requires (std::same_as<T, float> || std::same_as<T, double>)
+	inline void convert_batch(const UnitId& in, std::span<const Vector3<T>> input, const UnitId& out, std::span<Vector3<T>> output, const simd::InstructionSet& isa = simd::active())
+	{
+		static_assert(sizeof(Vector3<T>) == sizeof(T) * 3ull, "Vector3 must not contain padding!");
+		if (output.size() < input.size())
+			throw make_exception("convert() failed:  Output span is too small! (", output.size(), " < ", input.size(), ')');
+		simd::scale(&input.data()->x, &output.data()->x, input.size() * 3ull, conversion_factor<T>(in, out), isa);
+	}
+
+	/**
+	 * @struct		VectorBatch
+	 * @brief		A structure-of-arrays batch of vectors, which keeps each component in its own contiguous array.
+	 *\n			This is the layout to use when the components are processed separately, such as when computing bounding boxes.
+	 * @tparam T	The floating-point type of each component.
+	 */
+	template<std::floating_point T>
+	struct VectorBatch {
+		std::vector<T> x, y, z;
+
+		size_t size() const noexcept { return x.size(); }
+		bool empty() const noexcept { return x.empty(); }
+		void reserve(const size_t& n) { x.reserve(n); y.reserve(n); z.reserve(n); }
+		void clear() noexcept { x.clear(); y.clear(); z.clear(); }
+		void push_back(const Vector3<T>& vec)
+		{
+			x.push_back(vec.x);
+			y.push_back(vec.y);
+			z.push_back(vec.z);
+		}
+		Vector3<T> operator[](const size_t& i) const noexcept { return{ x[i], y[i], z[i] }; }
+	};
+
+	/**
+	 * @brief		Convert every vector in a structure-of-arrays batch in place, using the best SIMD kernel available for each component array.
+	 * @param in	Input Unit.
+	 * @param batch	The vectors to convert.
+	 * @param out	Output Unit.
+	 */
+	template<typename T> requires (std::same_as<T, float> || std::same_as<T, double>)
+	inline void convert_batch(const UnitId& in, VectorBatch<T>& batch, const UnitId& out, const simd::InstructionSet& isa = simd::active())
+	{
+		if (batch.y.size() != batch.x.size() || batch.z.size() != batch.x.size())
+			throw make_exception("convert() failed:  Vector batch components have different sizes! (", batch.x.size(), ", ", batch.y.size(), ", ", batch.z.size(), ')');
+		const auto factor{ conversion_factor<T>(in, out) };
+		for (auto* component : { &batch.x, &batch.y, &batch.z })
+			simd::scale(component->data(), component->data(), component->size(), factor, isa);
+	}
+
+	//#define DISABLE_NUTJOB_UNITS
+
+	/**
+	 * @class	UnitLookup
+	 * @brief	Precompiled index of every accepted unit symbol, name & spelling, used by getUnit().
+	 *\n		Each rule is assigned a priority equal to its position in the lookup order below, and a token
+	 *\n		 resolves to the matching rule with the lowest priority. This is what allows "met" to be checked
+	 *\n		 after every prefixed metre form, and "unit" after every prefixed unit form.
+	 *\n		Substrings are matched with an Aho-Corasick automaton over lowercase letters, and symbols are
+	 *\n		 matched against a sorted table of packed keys, so a lookup is O(length) and never allocates.
+	 *\n		The whole index lives in fixed-size arrays so that it can be built by the compiler.
+	 */
+	class UnitLookup {
+		using priority_t = std::uint8_t;
+		using state_t = std::uint16_t;
+
+		static constexpr const priority_t NONE{ std::numeric_limits<priority_t>::max() };
+		static constexpr const size_t ALPHABET{ 26ull }, MAX_SYMBOL_LENGTH{ sizeof(std::uint32_t) };
+		/// @brief	Fixed capacities of the index; exceeding any of these is a compile-time error.
+		static constexpr const size_t MAX_RULES{ 64ull }, MAX_KEYS{ 64ull }, MAX_STATES{ 256ull };
+
+		using key_t = std::pair<std::uint32_t, priority_t>;
+
+		/// @brief	The unit returned by each rule, indexed by priority.
+		std::array<UnitId, MAX_RULES> rules{};
+		size_t rule_count{ 0ull };
+		/// @brief	Case-sensitive symbols, and lowercase exact names. Sorted by key.
+		std::array<key_t, MAX_KEYS> symbols{}, lowercase{};
+		size_t symbol_count{ 0ull }, lowercase_count{ 0ull };
+		/// @brief	Automaton transitions for each state, including failure transitions.
+		std::array<std::array<state_t, ALPHABET>, MAX_STATES> next{};
+		size_t state_count{ 1ull };
+		/// @brief	The lowest priority of any pattern that ends at each state.
+		std::array<priority_t, MAX_STATES> out{};
+
+		/// @brief	Bounds check used while building the index. Not a constant expression when it fails, so an overflow stops compilation.
+		static constexpr void ensure(const bool& condition)
+		{
+			if (!condition)
+				throw make_exception("UnitLookup capacity exceeded!");
+		}
+
+		static constexpr char lower(const char& ch) noexcept { return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch; }
+
+		/// @brief	Pack a string of up to 4 characters into an integer key, optionally lowercasing it.
+		static constexpr std::uint32_t pack(const std::string_view& str, const bool& to_lower) noexcept
+		{
+			std::uint32_t key{ 0u };
+			for (const auto& ch : str)
+				key = (key << 8u) | static_cast<std::uint8_t>(to_lower ? lower(ch) : ch);
+			return key;
+		}
+
+		static constexpr priority_t find(const std::array<key_t, MAX_KEYS>& table, const size_t& count, const std::uint32_t& key) noexcept
+		{
+			const auto end{ table.begin() + count };
+			const auto it{ std::lower_bound(table.begin(), end, key, [](auto&& pr, auto&& k) { return pr.first < k; }) };
+			return (it != end && it->first == key) ? it->second : NONE;
+		}
+
+		/**
+		 * @brief			Add a rule to the index.
+		 * @param unit		The unit that this rule resolves to.
+		 * @param syms		Case-sensitive symbols that must match the whole string.
+		 * @param names		Case-insensitive names that must match the whole string.
+		 * @param substrs	Case-insensitive spellings that may appear anywhere in the string.
+		 */
+		constexpr void rule(const Unit* unit, std::initializer_list<std::string_view> syms, std::initializer_list<std::string_view> names, std::initializer_list<std::string_view> substrs)
+		{
+			ensure(rule_count < MAX_RULES && symbol_count + syms.size() <= MAX_KEYS && lowercase_count + names.size() <= MAX_KEYS);
+			const auto priority{ static_cast<priority_t>(rule_count) };
+			rules[rule_count++] = unit->getId();
+			for (const auto& sym : syms)
+				symbols[symbol_count++] = { pack(sym, false), priority };
+			for (const auto& name : names)
+				lowercase[lowercase_count++] = { pack(name, true), priority };
+			for (const auto& substr : substrs) {
+				state_t state{ 0 };
+				for (const auto& ch : substr) {
+					const auto c{ static_cast<size_t>(lower(ch) - 'a') };
+					if (next[state][c] == 0) {
+						ensure(state_count < MAX_STATES);
+						const auto child{ static_cast<state_t>(state_count++) };
+						out[child] = NONE;
+						next[state][c] = child;
+					}
+					state = next[state][c];
+				}
+				out[state] = std::min(out[state], priority);
+			}
+		}
+
+		/// @brief	Resolve failure links into direct transitions, and merge the output of each state's longest proper suffix.
+		constexpr void compile()
+		{
+			std::sort(symbols.begin(), symbols.begin() + symbol_count);
+			std::sort(lowercase.begin(), lowercase.begin() + lowercase_count);
+
+			std::array<state_t, MAX_STATES> fail{}, queue{};
+			size_t queue_size{ 0ull };
+			for (size_t c{ 0ull }; c < ALPHABET; ++c)
+				if (const auto child{ next[0][c] }; child != 0)
+					queue[queue_size++] = child;
+			for (size_t i{ 0ull }; i < queue_size; ++i) {
+				const auto state{ queue[i] };
+				out[state] = std::min(out[state], out[fail[state]]);
+				for (size_t c{ 0ull }; c < ALPHABET; ++c) {
+					if (const auto child{ next[state][c] }; child != 0) {
+						fail[child] = next[fail[state]][c];
+						queue[queue_size++] = child;
+					}
+					else next[state][c] = next[fail[state]][c];
+				}
+			}
+		}
+
+	public:
+		constexpr UnitLookup()
+		{
+			out[0] = NONE;
+			// BEGIN IMPERIAL //
+			#ifndef DISABLE_NUTJOB_UNITS
+			rule(Imperial.TWIP, {}, {}, { "twip" });
+			rule(Imperial.THOU, { "th" }, {}, { "thou" });
+			rule(Imperial.BARLEYCORN, { "Bc" }, {}, { "barleycorn" });
+			rule(Imperial.HAND, { "h" }, {}, { "hand" });
+			rule(Imperial.CHAIN, { "ch" }, {}, { "chain" });
+			rule(Imperial.FURLONG, { "fur" }, {}, { "furlong" });
+			rule(Imperial.LEAGUE, { "lea" }, {}, { "league" });
+			rule(Imperial.FATHOM, { "ftm" }, {}, { "fathom" });
+			rule(Imperial.CABLE, {}, {}, { "cable" });
+			rule(Imperial.LINK, {}, {}, { "link" });
+			rule(Imperial.ROD, { "rd" }, {}, { "rod" });
+			#endif // DISABLE_NUTJOB_UNITS
+			rule(Imperial.INCH, { "in" }, { "i" }, { "inch" });
+			rule(Imperial.FOOT, { "ft" }, { "f" }, { "foot", "feet" });
+			rule(Imperial.YARD, { "yd" }, {}, { "yard" });
+			rule(Imperial.CABLE, { "nmi" }, {}, { "nauticalmile", "nmile" });
+			rule(Imperial.MILE, { "mi" }, {}, { "mile" });
+			// END IMPERIAL //
+
+			// BEGIN METRIC //
+			// comparisons omit -er|-re to allow both the American and British spelling of "meter|metre".
+			rule(Metric.PICOMETER, { "pm" }, {}, { "picomet" });
+			rule(Metric.NANOMETER, { "nm" }, {}, { "nanomet" });
+			rule(Metric.MICROMETER, { "um" }, {}, { "micromet" });
+			rule(Metric.MILLIMETER, { "mm" }, {}, { "millimet" });
+			rule(Metric.CENTIMETER, { "cm" }, {}, { "centimet" });
+			rule(Metric.DECIMETER, { "dm" }, {}, { "decimet" });
+			rule(Metric.DECAMETER, { "dam" }, {}, { "decamet" });
+			rule(Metric.HECTOMETER, { "hm" }, {}, { "hectomet" });
+			rule(Metric.KILOMETER, { "km" }, {}, { "kilomet" });
+			rule(Metric.MEGAMETER, { "Mm" }, {}, { "megamet" });
+			rule(Metric.GIGAMETER, { "Gm" }, {}, { "gigamet" });
+			rule(Metric.TERAMETER, { "Tm" }, {}, { "teramet" });
+			// this has to be checked after all prefix types
+			rule(Metric.METER, { "m" }, {}, { "met" });
+			// END METRIC //
+
+			// BEGIN CREATIONKIT //
+			rule(CreationKit.PICOUNIT, { "pu" }, {}, { "picounit" });
+			rule(CreationKit.NANOUNIT, { "nu" }, {}, { "nanounit" });
+			rule(CreationKit.MICROUNIT, { "uu" }, {}, { "microunit" });
+			rule(CreationKit.MILLIUNIT, { "mu" }, {}, { "milliunit" });
+			rule(CreationKit.CENTIUNIT, { "cu" }, {}, { "centiunit" });
+			rule(CreationKit.DECIUNIT, { "du" }, {}, { "deciunit" });
+			rule(CreationKit.DECAUNIT, { "dau" }, {}, { "decaunit" });
+			rule(CreationKit.HECTOUNIT, { "hu" }, {}, { "hectounit" });
+			rule(CreationKit.KILOUNIT, { "ku" }, {}, { "kilounit" });
+			rule(CreationKit.MEGAUNIT, { "Mu" }, {}, { "megaunit" });
+			rule(CreationKit.GIGAUNIT, { "Gu" }, {}, { "gigaunit" });
+			rule(CreationKit.TERAUNIT, { "Tu" }, {}, { "teraunit" });
+			// this has to be checked after all prefix types
+			rule(CreationKit.UNIT, { "u" }, {}, { "unit" });
+			// END CREATIONKIT //
+
+			compile();
+		}
+
+		/**
+		 * @brief		Find the unit that a string refers to.
+		 * @param str	Input String, containing a unit symbol or name.
+		 * @returns		std::optional<UnitId>; std::nullopt when the string doesn't match any rule.
+		 */
+		constexpr std::optional<UnitId> find(const std::string_view& str) const noexcept
+		{
+			priority_t best{ NONE };
+			if (str.size() <= MAX_SYMBOL_LENGTH)
+				best = std::min(find(symbols, symbol_count, pack(str, false)), find(lowercase, lowercase_count, pack(str, true)));
+			state_t state{ 0 };
+			for (const auto& ch : str) {
+				const auto c{ lower(ch) };
+				state = (c >= 'a' && c <= 'z') ? next[state][c - 'a'] : 0;
+				best = std::min(best, out[state]);
+			}
+			if (best == NONE)
+				return std::nullopt;
+			return rules[best];
+		}
+	};
+
+	/// @brief	The unit lookup index used by getUnit(). This is built entirely at compile time.
+	inline constexpr const UnitLookup UnitIndex{};
+
+	/**
+	 * @brief		Retrieve the unit specified by a string containing the unit's official symbol, or name, without throwing.
+	 * @param str	Input String. (This is not processed beyond case-conversion)
+	 * @returns		expected<UnitId, Error>; Error::EMPTY_UNIT or Error::UNKNOWN_UNIT when the string isn't a unit.
+	 */
+	inline expected<UnitId, Error> find_unit(const std::string_view& str) noexcept
+	{
+		if (str.empty())
+			return unexpected{ Error::EMPTY_UNIT };
+		if (const auto id{ UnitIndex.find(str) }; id.has_value())
+			return id.value();
+		return unexpected{ Error::UNKNOWN_UNIT };
+	}
+
+	namespace detail {
+		/// @brief	Returns true when both strings are equal, ignoring the case of ASCII letters.
+		inline constexpr bool iequals(const std::string_view& l, const std::string_view& r) noexcept
+		{
+			constexpr auto lower{ [](const char& ch) { return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch; } };
+			return l.size() == r.size() && std::equal(l.begin(), l.end(), r.begin(), [&lower](auto&& a, auto&& b) { return lower(a) == lower(b); });
+		}
+	}
+
+	/**
+	 * @brief		Retrieve the measurement system specified by its name or one of its abbreviations, case-insensitively.
+	 * @param str	"m" or "metric"; "i" or "imperial"; "ck", "u", "unit(s)", "creationkit", "gamebryo" or "engine".
+	 * @returns		std::optional<SystemID>; std::nullopt when the string isn't a measurement system.
+	 */
+	inline constexpr std::optional<SystemID> find_system(const std::string_view& str) noexcept
+	{
+		constexpr const std::pair<SystemID, std::string_view> NAMES[]{
+			{ SystemID::METRIC, "m" }, { SystemID::METRIC, "metric" },
+			{ SystemID::IMPERIAL, "i" }, { SystemID::IMPERIAL, "imperial" },
+			{ SystemID::CREATIONKIT, "creationkit" }, { SystemID::CREATIONKIT, "creation kit" }, { SystemID::CREATIONKIT, "ck" },
+			{ SystemID::CREATIONKIT, "gamebryo" }, { SystemID::CREATIONKIT, "engine" }, { SystemID::CREATIONKIT, "unit" },
+			{ SystemID::CREATIONKIT, "units" }, { SystemID::CREATIONKIT, "un" }, { SystemID::CREATIONKIT, "u" },
+		};
+		for (const auto& [system, name] : NAMES)
+			if (detail::iequals(str, name))
+				return system;
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief		Check if a string is written as a list of targets for find_units() rather than a single unit; it contains a comma, or starts with "all" (case-insensitive).
+	 *\n			Lists have to be recognized before a unit is looked up, since unit names match substrings; "all:metric" contains "met".
+	 */
+	inline constexpr bool is_unit_list(const std::string_view& str) noexcept
+	{
+		return str.find(',') != std::string_view::npos || detail::iequals(str.substr(0ull, str.find(':')), "all");
+	}
+
+	/**
+	 * @brief		Retrieve every unit in a comma-separated list of targets, without throwing; used by fan-out conversions such as "5 m -> u,ft,cm".
+	 *\n			Each target is a unit, "all" for every unit, or "all:<system>" for every unit in one measurement system (see find_system()).
+	 * @param str	Input String.
+	 * @param units	Receives the units, in order. This is cleared first.
+	 * @returns		expected<size_t, Error>; the number of units, or the error of the first invalid target.
+	 */
+	inline expected<size_t, Error> find_units(const std::string_view& str, std::vector<UnitId>& units)
+	{
+		units.clear();
+		if (str.empty())
+			return unexpected{ Error::EMPTY_UNIT };
+		for (size_t begin{ 0ull }; begin <= str.size();) {
+			auto end{ str.find(',', begin) };
+			if (end == std::string_view::npos)
+				end = str.size();
+			const auto target{ str.substr(begin, end - begin) };
+			if (detail::iequals(target.substr(0ull, target.find(':')), "all")) {
+				auto system{ SystemID::ALL };
+				if (target.size() > 3ull) {
+					const auto found{ find_system(target.substr(4ull)) };
+					if (!found.has_value())
+						return unexpected{ Error::UNKNOWN_UNIT };
+					system = found.value();
+				}
+				for (const auto& unit : units_of(system))
+					units.emplace_back(unit.getId());
+			}
+			else if (const auto id{ find_unit(target) }; id.has_value())
+				units.emplace_back(id.value());
+			else return unexpected{ id.error() };
+			begin = end + 1ull;
+		}
+		return units.size();
+	}
+
+	/**
+	 * @brief		Retrieve the unit specified by a string containing the unit's official symbol, or name.
+	 * @param str	Input String. (This is not processed beyond case-conversion)
+	 * @param def	Optional default return value if the string is invalid.
+	 * @returns		UnitId; use getUnit(UnitId) to retrieve the unit's symbol, name & conversion factor.
+	 */
+	inline UnitId getUnit(const std::string_view& str, const std::optional<UnitId>& def = std::nullopt)
+	{
+		const auto id{ find_unit(str) };
+		if (id.has_value())
+			return id.value();
+		else if (def.has_value())
+			return def.value();
+		else if (id.error() == Error::EMPTY_UNIT)
+			throw make_exception("No unit specified ; string was empty!");
+		throw make_exception("Unrecognized Unit: \"", str, '\"');
+	}
+}
@@ -0,0 +1,127 @@
+/**
+ * @file	expected.hpp
+ * @author	radj307
+ * @brief	Contains the error codes of the non-throwing conversion path, and ckconv::expected, which is std::expected when it is available.
+ */
+#pragma once
+#include <string_view>
+#include <exception>
+#include <utility>
+#include <variant>
+#include <version>
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#include <expected>
+#endif
+
+namespace ckconv {
+	/**
+	 * @enum	Error
+	 * @brief	The reasons that a word can't be parsed or converted.
+	 */
+	enum class Error : char {
+		/// @brief	No unit was specified.
+		EMPTY_UNIT,
+		/// @brief	The word isn't a recognized unit symbol or name.
+		UNKNOWN_UNIT,
+		/// @brief	The word isn't a number.
+		INVALID_NUMBER,
+		/// @brief	The number is too large or too small to be represented.
+		NUMBER_OUT_OF_RANGE,
+		/// @brief	The word isn't an x,y,z vector.
+		INVALID_VECTOR,
+	};
+
+	/// @brief	Get a short description of an error.
+	inline constexpr std::string_view error_message(const Error& error) noexcept
+	{
+		switch (error) {
+		case Error::EMPTY_UNIT:
+			return "No unit specified";
+		case Error::UNKNOWN_UNIT:
+			return "Unrecognized Unit";
+		case Error::INVALID_NUMBER:
+			return "Invalid Number";
+		case Error::NUMBER_OUT_OF_RANGE:
+			return "Number out of range";
+		case Error::INVALID_VECTOR:
+			return "Invalid Vector";
+		default:
+			return "Unknown error";
+		}
+	}
+
+	#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+	template<typename T, typename E>
+	using expected = std::expected<T, E>;
+	using std::unexpected;
+	#else
+	/**
+	 * @class		unexpected
+	 * @brief		Wraps an error so that it can be returned as an expected; a subset of std::unexpected.
+	 * @tparam E	Error type.
+	 */
+	template<typename E>
+	class unexpected {
+		E _error;
+
+	public:
+		constexpr explicit unexpected(E error) : _error{ std::move(error) } {}
+
+		constexpr const E& error() const& noexcept { return _error; }
+		constexpr E& error() & noexcept { return _error; }
+	};
+	template<typename E>
+	unexpected(E) -> unexpected<E>;
+
+	/// @brief	Thrown by expected::value() when it contains an error.
+	struct bad_expected_access : std::exception {
+		const char* what() const noexcept override { return "bad expected access"; }
+	};
+
+	/**
+	 * @class		expected
+	 * @brief		Holds either a value or an error; a subset of std::expected for standard libraries that don't have it yet.
+	 * @tparam T	Value type.
+	 * @tparam E	Error type.
+	 */
+	template<typename T, typename E>
+	class expected {
+		std::variant<T, E> _v;
+
+	public:
+		using value_type = T;
+		using error_type = E;
+
+		constexpr expected(const T& value) : _v{ std::in_place_index<0>, value } {}
+		constexpr expected(T&& value) : _v{ std::in_place_index<0>, std::move(value) } {}
+		template<typename G>
+		constexpr expected(const unexpected<G>& error) : _v{ std::in_place_index<1>, error.error() } {}
+
+		constexpr bool has_value() const noexcept { return _v.index() == 0ull; }
+		constexpr explicit operator bool() const noexcept { return has_value(); }
+
+		constexpr const T& value() const&
+		{
+			if (!has_value())
+				throw bad_expected_access{};
+			return *std::get_if<0>(&_v);
+		}
+		constexpr T& value() &
+		{
+			if (!has_value())
+				throw bad_expected_access{};
+			return *std::get_if<0>(&_v);
+		}
+		constexpr const E& error() const& noexcept { return *std::get_if<1>(&_v); }
+
+		constexpr const T& operator*() const& noexcept { return *std::get_if<0>(&_v); }
+		constexpr T& operator*() & noexcept { return *std::get_if<0>(&_v); }
+		constexpr const T* operator->() const noexcept { return std::get_if<0>(&_v); }
+		constexpr T* operator->() noexcept { return std::get_if<0>(&_v); }
+
+		template<typename U>
+		constexpr T value_or(U&& def) const& { return has_value() ? **this : static_cast<T>(std::forward<U>(def)); }
+	};
+	#endif
+}
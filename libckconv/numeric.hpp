@@ -0,0 +1,176 @@
+/**
+ * @file	numeric.hpp
+ * @author	radj307
+ * @brief	Contains locale-independent, allocation-free number parsing & formatting.
+ */
+#pragma once
+#include <charconv>
+#include <concepts>
+#include <string_view>
+#include <string>
+#include <cstdio>
+#include <system_error>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+
+namespace ckconv {
+	/// @brief	The separator that may be used to group the digits of an input number, such as "1,000,000".
+	inline constexpr const char THOUSANDS_SEPARATOR{ ',' };
+	/// @brief	The maximum length of an input number, excluding thousands separators.
+	inline constexpr const size_t MAX_NUMBER_LENGTH{ 128ull };
+
+	/**
+	 * @brief		Parse a decimal number from a string, in place.
+	 *\n			The whole string must be a number; thousands separators are skipped, and a leading '+' is accepted.
+	 *\n			Unlike str::stold, this never allocates, never throws, and doesn't depend on the process locale.
+	 * @param str	Input String.
+	 * @param value	Receives the parsed number. This is only modified when parsing succeeds.
+	 * @returns		std::errc; std::errc{} on success, std::errc::invalid_argument if the string isn't a number,
+	 *\n			 std::errc::result_out_of_range if the number can't be represented by T, or
+	 *\n			 std::errc::value_too_large if the string is longer than MAX_NUMBER_LENGTH.
+	 */
+	template<std::floating_point T>
+	inline std::errc parse_number(std::string_view str, T& value) noexcept
+	{
+		if (!str.empty() && str.front() == '+')
+			str.remove_prefix(1ull);
+
+		// only accept plain decimal numbers, so that words like "inf" & "nan" are never mistaken for values
+		if (const auto digits{ (!str.empty() && str.front() == '-') ? str.substr(1ull) : str };
+			digits.empty() || !((digits.front() >= '0' && digits.front() <= '9') || digits.front() == '.'))
+			return std::errc::invalid_argument;
+
+		// remove thousands separators by copying into a stack buffer, only when there are any
+		char buffer[MAX_NUMBER_LENGTH + 1ull];
+		if (str.find(THOUSANDS_SEPARATOR) != std::string_view::npos) {
+			size_t len{ 0ull };
+			for (const auto& ch : str) {
+				if (ch == THOUSANDS_SEPARATOR)
+					continue;
+				if (len == MAX_NUMBER_LENGTH)
+					return std::errc::value_too_large;
+				buffer[len++] = ch;
+			}
+			str = { buffer, len };
+		}
+
+		T result{};
+		#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+		const auto [ptr, ec] { std::from_chars(str.data(), str.data() + str.size(), result, std::chars_format::general) };
+		if (ec != std::errc{})
+			return ec;
+		if (ptr != str.data() + str.size())
+			return std::errc::invalid_argument;
+		#else // the standard library doesn't support floating-point from_chars; fall back to strtod, which is locale-independent as long as the "C" locale is active.
+		if (str.size() > MAX_NUMBER_LENGTH)
+			return std::errc::value_too_large;
+		if (str.data() != buffer) {
+			std::copy(str.begin(), str.end(), buffer);
+			str = { buffer, str.size() };
+		}
+		buffer[str.size()] = '\0';
+		char* end{ nullptr };
+		errno = 0;
+		if constexpr (std::same_as<T, float>)
+			result = std::strtof(buffer, &end);
+		else if constexpr (std::same_as<T, double>)
+			result = std::strtod(buffer, &end);
+		else
+			result = std::strtold(buffer, &end);
+		if (end != buffer + str.size())
+			return std::errc::invalid_argument;
+		if (errno == ERANGE)
+			return std::errc::result_out_of_range;
+		#endif
+
+		value = result;
+		return std::errc{};
+	}
+
+	/**
+	 * @enum	Notation
+	 * @brief	Output notation for formatted numbers.
+	 */
+	enum class Notation : char {
+		/// @brief	Equivalent to printf's %g, and to std::ostream without a floatfield.
+		AUTO,
+		/// @brief	Equivalent to printf's %f, and to std::fixed.
+		FIXED,
+		/// @brief	Equivalent to printf's %e, and to std::scientific.
+		SCIENTIFIC,
+	};
+
+	/// @brief	The default output precision, matching std::ostream.
+	inline constexpr const int DEFAULT_PRECISION{ 6 };
+
+	/**
+	 * @brief			Format a number & append it to the given string.
+	 *\n				The output is identical to inserting the number into a std::ostream with the same precision & floatfield,
+	 *\n				 but nothing is allocated once out has enough capacity.
+	 * @param out		The string to append to.
+	 * @param value		The number to format.
+	 * @param precision	The number of digits to show, as with std::ostream::precision(). Negative values use DEFAULT_PRECISION.
+	 * @param notation	The notation to use.
+	 */
+	template<std::floating_point T>
+	inline void append_number(std::string& out, const T& value, int precision = DEFAULT_PRECISION, const Notation& notation = Notation::AUTO)
+	{
+		if (precision < 0)
+			precision = DEFAULT_PRECISION;
+		const auto pos{ out.size() };
+		// enough space for any number in scientific notation; fixed notation may need more, in which case this is grown below.
+		size_t length{ static_cast<size_t>(precision) + 32ull };
+
+		for (;;) {
+			out.resize(pos + length);
+			char* const first{ out.data() + pos }, * const last{ out.data() + out.size() };
+			#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+			const auto fmt{ notation == Notation::FIXED ? std::chars_format::fixed : (notation == Notation::SCIENTIFIC ? std::chars_format::scientific : std::chars_format::general) };
+			if (const auto [ptr, ec] { std::to_chars(first, last, value, fmt, precision) }; ec == std::errc{}) {
+				out.resize(static_cast<size_t>(ptr - out.data()));
+				return;
+			}
+			#else // the standard library doesn't support floating-point to_chars; fall back to snprintf.
+			const char* const fmt{ notation == Notation::FIXED ? "%.*Lf" : (notation == Notation::SCIENTIFIC ? "%.*Le" : "%.*Lg") };
+			if (const auto count{ std::snprintf(first, length, fmt, precision, static_cast<long double>(value)) }; count >= 0 && static_cast<size_t>(count) < length) {
+				out.resize(pos + static_cast<size_t>(count));
+				return;
+			}
+			#endif
+			length *= 4ull;
+		}
+	}
+
+	/**
+	 * @enum	NumberType
+	 * @brief	The floating-point type that values are parsed, converted & formatted in.
+	 *\n		long double is the most accurate, but on x86-64 it uses x87 instructions that can't be vectorized;
+	 *\n		 float & double are faster, and accurate enough for most inputs. See the README for a comparison.
+	 */
+	enum class NumberType : char {
+		FLOAT,
+		DOUBLE,
+		LONG_DOUBLE,
+	};
+
+	/**
+	 * @brief			Call a function template with the floating-point type selected by a NumberType.
+	 * @param type		The number type to use.
+	 * @param func		A callable with a template call operator, such as `[]<typename T>() { ... }`.
+	 * @returns			The result of calling `func.template operator()<T>()`.
+	 */
+	template<typename F>
+	inline decltype(auto) visit_number_type(const NumberType& type, F&& func)
+	{
+		switch (type) {
+		case NumberType::FLOAT:
+			return func.template operator()<float>();
+		case NumberType::DOUBLE:
+			return func.template operator()<double>();
+		case NumberType::LONG_DOUBLE: [[fallthrough]];
+		default:
+			return func.template operator()<long double>();
+		}
+	}
+}
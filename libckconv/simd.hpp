@@ -0,0 +1,163 @@
+/**
+ * @file	simd.hpp
+ * @author	radj307
+ * @brief	Contains runtime-dispatched SIMD kernels used by the batch conversion API.
+ */
+#pragma once
+#include <sysarch.h>
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CKCONV_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(CKCONV_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CKCONV_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CKCONV_SIMD_TARGET(isa)
+#endif
+
+namespace ckconv::simd {
+	/**
+	 * @enum	InstructionSet
+	 * @brief	The instruction sets that kernels are available for.
+	 */
+	enum class InstructionSet : char {
+		SCALAR,
+		SSE2,
+		AVX2,
+	};
+
+	/// @brief	Detect the best instruction set supported by the current processor.
+	inline InstructionSet detect() noexcept
+	{
+		#ifdef CKCONV_SIMD_X86
+		#ifdef _MSC_VER
+		int info[4]{};
+		__cpuid(info, 0);
+		const int max_leaf{ info[0] };
+		__cpuid(info, 1);
+		const bool sse2{ (info[3] & (1 << 26)) != 0 };
+		// AVX2 also requires the OS to save the YMM registers (OSXSAVE + XCR0)
+		const bool osxsave{ (info[2] & (1 << 27)) != 0 }, avx{ (info[2] & (1 << 28)) != 0 };
+		if (max_leaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+			__cpuidex(info, 7, 0);
+			if ((info[1] & (1 << 5)) != 0)
+				return InstructionSet::AVX2;
+		}
+		return sse2 ? InstructionSet::SSE2 : InstructionSet::SCALAR;
+		#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return InstructionSet::AVX2;
+		if (__builtin_cpu_supports("sse2"))
+			return InstructionSet::SSE2;
+		#endif
+		#endif
+		return InstructionSet::SCALAR;
+	}
+
+	/// @brief	The instruction set used by default; this is detected once, on first use.
+	inline InstructionSet active() noexcept
+	{
+		static const InstructionSet isa{ detect() };
+		return isa;
+	}
+
+	/// @brief	Get the name of an instruction set.
+	inline constexpr const char* name(const InstructionSet& isa) noexcept
+	{
+		switch (isa) {
+		case InstructionSet::AVX2:
+			return "avx2";
+		case InstructionSet::SSE2:
+			return "sse2";
+		default:
+			return "scalar";
+		}
+	}
+
+	/// @brief	Multiply each element of in by factor, writing the result to out.
+	template<std::floating_point T>
+	inline void scale_scalar(const T* in, T* out, const size_t& n, const T& factor) noexcept
+	{
+		for (size_t i{ 0ull }; i < n; ++i)
+			out[i] = in[i] * factor;
+	}
+
+	#ifdef CKCONV_SIMD_X86
+	CKCONV_SIMD_TARGET("sse2") inline void scale_sse2(const float* in, float* out, const size_t& n, const float& factor) noexcept
+	{
+		const __m128 f{ _mm_set1_ps(factor) };
+		size_t i{ 0ull };
+		for (; i + 4ull <= n; i += 4ull)
+			_mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(in + i), f));
+		scale_scalar(in + i, out + i, n - i, factor);
+	}
+	CKCONV_SIMD_TARGET("sse2") inline void scale_sse2(const double* in, double* out, const size_t& n, const double& factor) noexcept
+	{
+		const __m128d f{ _mm_set1_pd(factor) };
+		size_t i{ 0ull };
+		for (; i + 2ull <= n; i += 2ull)
+			_mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(in + i), f));
+		scale_scalar(in + i, out + i, n - i, factor);
+	}
+	CKCONV_SIMD_TARGET("avx2") inline void scale_avx2(const float* in, float* out, const size_t& n, const float& factor) noexcept
+	{
+		const __m256 f{ _mm256_set1_ps(factor) };
+		size_t i{ 0ull };
+		for (; i + 16ull <= n; i += 16ull) {
+			_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(in + i), f));
+			_mm256_storeu_ps(out + i + 8ull, _mm256_mul_ps(_mm256_loadu_ps(in + i + 8ull), f));
+		}
+		for (; i + 8ull <= n; i += 8ull)
+			_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(in + i), f));
+		scale_scalar(in + i, out + i, n - i, factor);
+	}
+	CKCONV_SIMD_TARGET("avx2") inline void scale_avx2(const double* in, double* out, const size_t& n, const double& factor) noexcept
+	{
+		const __m256d f{ _mm256_set1_pd(factor) };
+		size_t i{ 0ull };
+		for (; i + 8ull <= n; i += 8ull) {
+			_mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(in + i), f));
+			_mm256_storeu_pd(out + i + 4ull, _mm256_mul_pd(_mm256_loadu_pd(in + i + 4ull), f));
+		}
+		for (; i + 4ull <= n; i += 4ull)
+			_mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(in + i), f));
+		scale_scalar(in + i, out + i, n - i, factor);
+	}
+	#endif
+
+	/**
+	 * @brief			Multiply each element of in by factor, writing the result to out.
+	 *\n				in & out may point to the same array, but must not otherwise overlap.
+	 * @param in		Input array.
+	 * @param out		Output array, which must be at least n elements long.
+	 * @param n			The number of elements to process.
+	 * @param factor	The factor to multiply by.
+	 * @param isa		The instruction set to use. It is limited to the best one supported by the processor, so requesting an
+	 *\n				 unsupported instruction set falls back to the next best kernel; without SIMD kernels in this build, the scalar kernel is used.
+	 */
+	template<typename T> requires (std::same_as<T, float> || std::same_as<T, double>)
+	inline void scale(const T* in, T* out, const size_t& n, const T& factor, const InstructionSet& isa = active()) noexcept
+	{
+		// InstructionSet is ordered from least to most capable
+		switch (std::min(isa, active())) {
+		#ifdef CKCONV_SIMD_X86
+		case InstructionSet::AVX2:
+			return scale_avx2(in, out, n, factor);
+		case InstructionSet::SSE2:
+			return scale_sse2(in, out, n, factor);
+		#endif
+		default:
+			return scale_scalar(in, out, n, factor);
+		}
+	}
+}
@@ -0,0 +1,225 @@
+/**
+ * @file	units.hpp
+ * @author	radj307
+ * @brief	Header-only typed unit API, for converting between units that are known at compile time.
+ *\n		Each unit in UNITS has a tag type in ckconv::units, and a user-defined literal in ckconv::literals:
+ *\n		```
+ *\n		using namespace ckconv::literals;
+ *\n		const double u{ ckconv::convert<ckconv::units::Meter, ckconv::units::Unit>(12.5) };
+ *\n		const auto q{ (300_u).to<ckconv::units::Meter>() };
+ *\n		```
+ *\n		The conversion factor is taken from the conversion table at compile time, so each conversion is a single multiply by a constant.
+ */
+#pragma once
+#include "conv.hpp"
+
+#include <compare>
+#include <concepts>
+#include <type_traits>
+
+namespace ckconv {
+	/**
+	 * @struct		unit_tag
+	 * @brief		Compile-time handle for a unit in UNITS.
+	 * @tparam ID	The unit's UnitId.
+	 */
+	template<UnitId ID>
+	struct unit_tag {
+		static constexpr const UnitId id{ ID };
+		static constexpr const Unit& unit{ UNITS[static_cast<size_t>(ID)] };
+	};
+
+	namespace units {
+		// METRIC
+		using Picometer = unit_tag<UnitId::PICOMETER>;
+		using Nanometer = unit_tag<UnitId::NANOMETER>;
+		using Micrometer = unit_tag<UnitId::MICROMETER>;
+		using Millimeter = unit_tag<UnitId::MILLIMETER>;
+		using Centimeter = unit_tag<UnitId::CENTIMETER>;
+		using Decimeter = unit_tag<UnitId::DECIMETER>;
+		using Meter = unit_tag<UnitId::METER>;
+		using Decameter = unit_tag<UnitId::DECAMETER>;
+		using Hectometer = unit_tag<UnitId::HECTOMETER>;
+		using Kilometer = unit_tag<UnitId::KILOMETER>;
+		using Megameter = unit_tag<UnitId::MEGAMETER>;
+		using Gigameter = unit_tag<UnitId::GIGAMETER>;
+		using Terameter = unit_tag<UnitId::TERAMETER>;
+		// IMPERIAL
+		using Twip = unit_tag<UnitId::TWIP>;
+		using Thou = unit_tag<UnitId::THOU>;
+		using Barleycorn = unit_tag<UnitId::BARLEYCORN>;
+		using Inch = unit_tag<UnitId::INCH>;
+		using Hand = unit_tag<UnitId::HAND>;
+		using Foot = unit_tag<UnitId::FOOT>;
+		using Yard = unit_tag<UnitId::YARD>;
+		using Chain = unit_tag<UnitId::CHAIN>;
+		using Furlong = unit_tag<UnitId::FURLONG>;
+		using Mile = unit_tag<UnitId::MILE>;
+		using League = unit_tag<UnitId::LEAGUE>;
+		using Fathom = unit_tag<UnitId::FATHOM>;
+		using Cable = unit_tag<UnitId::CABLE>;
+		using NauticalMile = unit_tag<UnitId::NAUTICAL_MILE>;
+		using Link = unit_tag<UnitId::LINK>;
+		using Rod = unit_tag<UnitId::ROD>;
+		// CREATIONKIT
+		using Picounit = unit_tag<UnitId::PICOUNIT>;
+		using Nanounit = unit_tag<UnitId::NANOUNIT>;
+		using Microunit = unit_tag<UnitId::MICROUNIT>;
+		using Milliunit = unit_tag<UnitId::MILLIUNIT>;
+		using Centiunit = unit_tag<UnitId::CENTIUNIT>;
+		using Deciunit = unit_tag<UnitId::DECIUNIT>;
+		using Unit = unit_tag<UnitId::UNIT>;
+		using Decaunit = unit_tag<UnitId::DECAUNIT>;
+		using Hectounit = unit_tag<UnitId::HECTOUNIT>;
+		using Kilounit = unit_tag<UnitId::KILOUNIT>;
+		using Megaunit = unit_tag<UnitId::MEGAUNIT>;
+		using Gigaunit = unit_tag<UnitId::GIGAUNIT>;
+		using Teraunit = unit_tag<UnitId::TERAUNIT>;
+	}
+
+	/// @brief	Satisfied by the unit tag types in ckconv::units.
+	template<typename T>
+	concept unit_tag_type = std::same_as<std::remove_cvref_t<T>, unit_tag<std::remove_cvref_t<T>::id>>;
+
+	/**
+	 * @brief	Satisfied when both units are tags, and the conversion table has a usable factor between them.
+	 *\n		Every unit is currently a length, so this only rejects non-tag types & illegal conversion factors;
+	 *\n		 it is the extension point for rejecting conversions between different quantities.
+	 */
+	template<typename From, typename To>
+	concept convertible_units = unit_tag_type<From> && unit_tag_type<To>
+		&& (From::unit.unitcf != 0.0L) && (To::unit.unitcf != 0.0L)
+		&& (conversion_factor(From::id, To::id) == conversion_factor(From::id, To::id)); // not NaN
+
+	/// @brief	The floating-point type that a value of type T is converted in; integers are converted as long double.
+	template<typename T>
+	using conversion_result_t = std::conditional_t<std::floating_point<T>, T, long double>;
+
+	/**
+	 * @brief			Convert a value between two units that are known at compile time.
+	 * @tparam From		Input unit tag, from ckconv::units.
+	 * @tparam To		Output unit tag, from ckconv::units.
+	 * @param value		Input value. Integers are converted as long double.
+	 * @returns			conversion_result_t<T>
+	 */
+	template<typename From, typename To, typename T> requires convertible_units<From, To> && std::is_arithmetic_v<T>
+	inline constexpr conversion_result_t<T> convert(const T& value) noexcept
+	{
+		using R = conversion_result_t<T>;
+		constexpr const R factor{ conversion_factor<R>(From::id, To::id) };
+		return static_cast<R>(value) * factor;
+	}
+
+	/**
+	 * @class		quantity
+	 * @brief		A value in a unit that is known at compile time, produced by the literals in ckconv::literals.
+	 * @tparam U	Unit tag, from ckconv::units.
+	 * @tparam T	Floating-point value type.
+	 */
+	template<unit_tag_type U, std::floating_point T = long double>
+	class quantity {
+		T _value;
+
+	public:
+		using unit_type = U;
+		using value_type = T;
+
+		constexpr quantity() noexcept : _value{ static_cast<T>(0) } {}
+		constexpr explicit quantity(const T& value) noexcept : _value{ value } {}
+
+		/// @brief	The value, in unit U.
+		constexpr T value() const noexcept { return _value; }
+		/// @brief	The unit that the value is in.
+		static constexpr const Unit& unit() noexcept { return U::unit; }
+
+		/// @brief	Convert to another unit.
+		template<typename To> requires convertible_units<U, To>
+		constexpr quantity<To, T> to() const noexcept { return quantity<To, T>{ convert<U, To>(_value) }; }
+
+		/// @brief	Convert from a quantity in another unit. This is explicit so that arithmetic never mixes units implicitly.
+		template<typename V> requires convertible_units<V, U>
+		constexpr explicit quantity(const quantity<V, T>& o) noexcept : _value{ convert<V, U>(o.value()) } {}
+
+		constexpr auto operator<=>(const quantity&) const noexcept = default;
+		constexpr quantity operator-() const noexcept { return quantity{ -_value }; }
+		constexpr quantity& operator+=(const quantity& o) noexcept { _value += o._value; return *this; }
+		constexpr quantity& operator-=(const quantity& o) noexcept { _value -= o._value; return *this; }
+		constexpr quantity& operator*=(const T& scalar) noexcept { _value *= scalar; return *this; }
+		constexpr quantity& operator/=(const T& scalar) noexcept { _value /= scalar; return *this; }
+		friend constexpr quantity operator+(quantity l, const quantity& r) noexcept { return l += r; }
+		friend constexpr quantity operator-(quantity l, const quantity& r) noexcept { return l -= r; }
+		friend constexpr quantity operator*(quantity l, const T& scalar) noexcept { return l *= scalar; }
+		friend constexpr quantity operator*(const T& scalar, quantity r) noexcept { return r *= scalar; }
+		friend constexpr quantity operator/(quantity l, const T& scalar) noexcept { return l /= scalar; }
+	};
+
+	/**
+	 * @brief			Convert a quantity to another unit.
+	 * @tparam To		Output unit tag, from ckconv::units.
+	 * @param q			Input quantity.
+	 * @returns			quantity<To, T>
+	 */
+	template<typename To, typename From, std::floating_point T> requires convertible_units<From, To>
+	inline constexpr quantity<To, T> convert(const quantity<From, T>& q) noexcept
+	{
+		return q.template to<To>();
+	}
+
+	/**
+	 * @brief	User-defined literals for every unit, named after the unit's symbol where it is a valid identifier.
+	 *\n		Inches & feet use `_in` & `_ft`; units without a symbol use their lowercase name (`_twip`, `_cable`, `_link`).
+	 */
+	namespace literals {
+	#define CKCONV_UNIT_LITERAL(TAG, SUFFIX) \
+		consteval quantity<units::TAG> operator""_##SUFFIX(long double value) noexcept { return quantity<units::TAG>{ value }; } \
+		consteval quantity<units::TAG> operator""_##SUFFIX(unsigned long long value) noexcept { return quantity<units::TAG>{ static_cast<long double>(value) }; }
+
+		// METRIC
+		CKCONV_UNIT_LITERAL(Picometer, pm)
+		CKCONV_UNIT_LITERAL(Nanometer, nm)
+		CKCONV_UNIT_LITERAL(Micrometer, um)
+		CKCONV_UNIT_LITERAL(Millimeter, mm)
+		CKCONV_UNIT_LITERAL(Centimeter, cm)
+		CKCONV_UNIT_LITERAL(Decimeter, dm)
+		CKCONV_UNIT_LITERAL(Meter, m)
+		CKCONV_UNIT_LITERAL(Decameter, dam)
+		CKCONV_UNIT_LITERAL(Hectometer, hm)
+		CKCONV_UNIT_LITERAL(Kilometer, km)
+		CKCONV_UNIT_LITERAL(Megameter, Mm)
+		CKCONV_UNIT_LITERAL(Gigameter, Gm)
+		CKCONV_UNIT_LITERAL(Terameter, Tm)
+		// IMPERIAL
+		CKCONV_UNIT_LITERAL(Twip, twip)
+		CKCONV_UNIT_LITERAL(Thou, th)
+		CKCONV_UNIT_LITERAL(Barleycorn, Bc)
+		CKCONV_UNIT_LITERAL(Inch, in)
+		CKCONV_UNIT_LITERAL(Hand, h)
+		CKCONV_UNIT_LITERAL(Foot, ft)
+		CKCONV_UNIT_LITERAL(Yard, yd)
+		CKCONV_UNIT_LITERAL(Chain, ch)
+		CKCONV_UNIT_LITERAL(Furlong, fur)
+		CKCONV_UNIT_LITERAL(Mile, mi)
+		CKCONV_UNIT_LITERAL(League, lea)
+		CKCONV_UNIT_LITERAL(Fathom, ftm)
+		CKCONV_UNIT_LITERAL(Cable, cable)
+		CKCONV_UNIT_LITERAL(NauticalMile, nmi)
+		CKCONV_UNIT_LITERAL(Link, link)
+		CKCONV_UNIT_LITERAL(Rod, rd)
+		// CREATIONKIT
+		CKCONV_UNIT_LITERAL(Picounit, pu)
+		CKCONV_UNIT_LITERAL(Nanounit, nu)
+		CKCONV_UNIT_LITERAL(Microunit, uu)
+		CKCONV_UNIT_LITERAL(Milliunit, mu)
+		CKCONV_UNIT_LITERAL(Centiunit, cu)
+		CKCONV_UNIT_LITERAL(Deciunit, du)
+		CKCONV_UNIT_LITERAL(Unit, u)
+		CKCONV_UNIT_LITERAL(Decaunit, dau)
+		CKCONV_UNIT_LITERAL(Hectounit, hu)
+		CKCONV_UNIT_LITERAL(Kilounit, ku)
+		CKCONV_UNIT_LITERAL(Megaunit, Mu)
+		CKCONV_UNIT_LITERAL(Gigaunit, Gu)
+		CKCONV_UNIT_LITERAL(Teraunit, Tu)
+
+	#undef CKCONV_UNIT_LITERAL
+	}
+}